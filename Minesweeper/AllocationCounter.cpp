@@ -0,0 +1,91 @@
+/*
+key components:
+- counted: every replaced operator new goes through here, one thread_local increment and
+  one relaxed atomic add, then malloc (aligned_alloc for over-aligned types)
+- delete: plain free, sized / aligned forms included so nothing reaches the default
+  operator delete with a pointer it didn't allocate
+*/
+
+#include "AllocationCounter.h"
+#include <atomic>
+#include <new>
+#include <cstdlib>
+
+#ifdef MINESWEEPER_ALLOC_CHECK
+
+static atomic<uint64_t> totalAllocations(0);
+static thread_local uint64_t threadAllocations = 0;
+
+static void* counted(size_t size) {
+    threadAllocations++;
+    totalAllocations.fetch_add(1, memory_order_relaxed);
+    return malloc(size ? size : 1);
+}
+
+static void* countedAligned(size_t size, align_val_t alignment) {
+    threadAllocations++;
+    totalAllocations.fetch_add(1, memory_order_relaxed);
+    size_t align = static_cast<size_t>(alignment);
+    size_t rounded = ((size ? size : 1) + align - 1) / align * align; // aligned_alloc wants a multiple
+    return aligned_alloc(align, rounded);
+}
+
+void* operator new(size_t size) {
+    void* memory = counted(size);
+    if (!memory) throw bad_alloc();
+    return memory;
+}
+
+void* operator new[](size_t size) {
+    void* memory = counted(size);
+    if (!memory) throw bad_alloc();
+    return memory;
+}
+
+void* operator new(size_t size, align_val_t alignment) {
+    void* memory = countedAligned(size, alignment);
+    if (!memory) throw bad_alloc();
+    return memory;
+}
+
+void* operator new[](size_t size, align_val_t alignment) {
+    void* memory = countedAligned(size, alignment);
+    if (!memory) throw bad_alloc();
+    return memory;
+}
+
+void* operator new(size_t size, const nothrow_t&) noexcept { return counted(size); }
+void* operator new[](size_t size, const nothrow_t&) noexcept { return counted(size); }
+void* operator new(size_t size, align_val_t alignment, const nothrow_t&) noexcept { return countedAligned(size, alignment); }
+void* operator new[](size_t size, align_val_t alignment, const nothrow_t&) noexcept { return countedAligned(size, alignment); }
+
+void operator delete(void* memory) noexcept { free(memory); }
+void operator delete[](void* memory) noexcept { free(memory); }
+void operator delete(void* memory, size_t) noexcept { free(memory); }
+void operator delete[](void* memory, size_t) noexcept { free(memory); }
+void operator delete(void* memory, align_val_t) noexcept { free(memory); }
+void operator delete[](void* memory, align_val_t) noexcept { free(memory); }
+void operator delete(void* memory, size_t, align_val_t) noexcept { free(memory); }
+void operator delete[](void* memory, size_t, align_val_t) noexcept { free(memory); }
+void operator delete(void* memory, const nothrow_t&) noexcept { free(memory); }
+void operator delete[](void* memory, const nothrow_t&) noexcept { free(memory); }
+
+uint64_t AllocationCounter::thisThread() {
+    return threadAllocations;
+}
+
+uint64_t AllocationCounter::total() {
+    return totalAllocations.load(memory_order_relaxed);
+}
+
+#else
+
+uint64_t AllocationCounter::thisThread() {
+    return 0;
+}
+
+uint64_t AllocationCounter::total() {
+    return 0;
+}
+
+#endif
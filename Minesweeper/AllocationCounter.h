@@ -0,0 +1,36 @@
+/*
+purpose: test-mode heap allocation counter, used to hold the game loop to zero allocations
+in a frame where nothing changed (allocator traffic shows up as jitter in long sessions)
+
+implementation:
+- only compiled in when the game is built with -DMINESWEEPER_ALLOC_CHECK, then
+  AllocationCounter.cpp replaces the global operator new / delete (every form) with
+  malloc / free plus a count, so SFML's own news are counted too (not what C code or the
+  GL driver mallocs directly)
+- counts are kept per thread as well as in total: the frame check only looks at the UI
+  thread, the leaderboard / journal / trace threads allocate on their own time
+- the SceneStack checks every quiet frame (no events, no scene change, the top scene says
+  it's idle, the profiler overlay off) from the top of the loop up to display() and aborts
+  with the frame number if anything was allocated
+- without the flag ALLOCATION_CHECK is false, the check compiles away and the counts are 0
+*/
+
+#ifndef ALLOCATIONCOUNTER_H
+#define ALLOCATIONCOUNTER_H
+
+#include <cstdint>
+using namespace std;
+
+#ifdef MINESWEEPER_ALLOC_CHECK
+static const bool ALLOCATION_CHECK = true;
+#else
+static const bool ALLOCATION_CHECK = false;
+#endif
+
+class AllocationCounter {
+public:
+    static uint64_t thisThread(); // operator new calls made by the calling thread so far
+    static uint64_t total();      // by every thread
+};
+
+#endif
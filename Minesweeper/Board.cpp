@@ -0,0 +1,260 @@
+/*
+key components:
+- generation: seeded mine placement, adjacent counts and 3BV in linear passes
+- tracing: generate, reveal, flood fills and chords are SessionTrace scopes
+- neighbours: tiles are indexed row * colCount + col, neighbours are computed on the fly
+- reveal: flood fills openings with a reused stack (no recursion)
+- chord: opens every unflagged neighbour of a satisfied number in one batch
+- change list: every action records the tiles it touched
+- toggleCells: flips one bit on a tile list and keeps revealed/flag counts and the lost state right
+- snapshots: copy the cell array + counters out and back in (board must be the same size)
+- storage: generate() takes the tiles from the arena, attachCells() adopts a mapped save
+  file's cells; both reset the arena first (the previous game's memory goes in one step)
+  and take the flood stack + changed list from it
+*/
+
+#include "Board.h"
+#include "SessionTrace.h"
+#include <random>
+#include <cstring>
+
+// calls f(neighbourIndex) for each of the (up to) 8 tiles around cell
+template <typename F>
+static void forEachNeighbour(int cell, int colCount, int rowCount, F f) {
+    int row = cell / colCount;
+    int col = cell % colCount;
+
+    for (int r = row - 1; r <= row + 1; ++r) {
+        if (r < 0 || r >= rowCount) continue;
+        for (int c = col - 1; c <= col + 1; ++c) {
+            if (c < 0 || c >= colCount || (r == row && c == col)) continue;
+            f(r * colCount + c);
+        }
+    }
+}
+
+Board::Board() : colCount(0), rowCount(0), mineCount(0), revealedCount(0), flagCount(0), bbbv(0), lost(false),
+    cells(nullptr), workStack(nullptr), changed(nullptr), changedCount(0) {}
+
+// every tile is pushed / changed at most once per action, so one slot per tile never runs out
+void Board::allocateScratch() {
+    workStack = arena.allocate<int>(getCellCount());
+    changed = arena.allocate<int>(getCellCount());
+    changedCount = 0;
+}
+
+void Board::generate(int colCount, int rowCount, int mineCount, uint64_t seed) {
+    SessionTrace::Scope trace("generate", "board");
+    trace.setArg("cells", static_cast<int64_t>(colCount) * rowCount);
+    this->colCount = colCount;
+    this->rowCount = rowCount;
+    this->mineCount = mineCount;
+    revealedCount = 0;
+    flagCount = 0;
+    lost = false;
+
+    mappedCells.close();
+    arena.reset();
+    cells = arena.allocate<uint8_t>(getCellCount());
+    memset(cells, 0, getCellCount());
+    allocateScratch();
+
+    placeMines(seed);
+    calculateAdjacentMines();
+    calculateBBBV();
+}
+
+void Board::attachCells(MappedFile&& storage, size_t offset, int colCount, int rowCount, int mineCount,
+                        int revealedCount, int flagCount, int bbbv, bool lost) {
+    mappedCells = move(storage);
+    arena.reset();
+    cells = mappedCells.getData() + offset;
+
+    this->colCount = colCount;
+    this->rowCount = rowCount;
+    this->mineCount = mineCount;
+    this->revealedCount = revealedCount;
+    this->flagCount = flagCount;
+    this->bbbv = bbbv;
+    this->lost = lost;
+    allocateScratch();
+}
+
+void Board::placeMines(uint64_t seed) {
+    // mt19937_64 output is the same on every platform, so the seed alone rebuilds the board
+    mt19937_64 rng(seed);
+    int minesPlaced = 0;
+
+    while (minesPlaced < mineCount) {
+        int randRow = rng() % rowCount; // using % so we dont overflow
+        int randCol = rng() % colCount;
+        uint8_t& cell = cells[randRow * colCount + randCol];
+
+        if (!(cell & MINE_BIT)) {
+            cell |= MINE_BIT;
+            minesPlaced++;
+        }
+    }
+}
+
+void Board::calculateAdjacentMines() {
+    int cellCount = getCellCount();
+    for (int cell = 0; cell < cellCount; ++cell) {
+        if (cells[cell] & MINE_BIT) continue;
+
+        int count = 0;
+        forEachNeighbour(cell, colCount, rowCount, [&](int adj) {
+            if (cells[adj] & MINE_BIT) count++;
+        });
+        cells[cell] |= count;
+    }
+}
+
+// 3BV = number of openings (connected areas of 0 tiles plus their border) + every numbered tile
+// that does not touch an opening. one linear pass over the number grid, each 0 tile is flooded once
+// (the revealed bit is borrowed as the "marked" flag and cleared again at the end)
+void Board::calculateBBBV() {
+    int cellCount = getCellCount();
+    bbbv = 0;
+
+    for (int start = 0; start < cellCount; ++start) {
+        if (cells[start] & (MINE_BIT | REVEALED_BIT | ADJACENT_MASK)) continue;
+
+        // new opening -> flood it so every tile it would reveal is marked
+        bbbv++;
+        cells[start] |= REVEALED_BIT;
+        int stackSize = 0;
+        workStack[stackSize++] = start;
+        while (stackSize > 0) {
+            int cell = workStack[--stackSize];
+            forEachNeighbour(cell, colCount, rowCount, [&](int adj) {
+                if (cells[adj] & REVEALED_BIT) return;
+                cells[adj] |= REVEALED_BIT;
+                if ((cells[adj] & ADJACENT_MASK) == 0) {
+                    workStack[stackSize++] = adj;
+                }
+            });
+        }
+    }
+
+    // numbered tiles outside any opening each need their own click
+    for (int cell = 0; cell < cellCount; ++cell) {
+        if (!(cells[cell] & (MINE_BIT | REVEALED_BIT))) {
+            bbbv++;
+        }
+        cells[cell] &= ~REVEALED_BIT;
+    }
+}
+
+// reveals a tile plus the whole opening behind it if it's a 0, no win/loss handling
+void Board::revealArea(int start) {
+    if (cells[start] & (REVEALED_BIT | FLAGGED_BIT)) return;
+
+    cells[start] |= REVEALED_BIT;
+    changed[changedCount++] = start;
+
+    if (cells[start] & MINE_BIT) {
+        lost = true;
+        return;
+    }
+    revealedCount++;
+
+    if (cells[start] & ADJACENT_MASK) return;
+
+    SessionTrace::Scope trace("flood fill", "board");
+    size_t changedBefore = changedCount;
+    int stackSize = 0;
+    workStack[stackSize++] = start;
+    while (stackSize > 0) {
+        int cell = workStack[--stackSize];
+
+        forEachNeighbour(cell, colCount, rowCount, [&](int adj) {
+            if (cells[adj] & (REVEALED_BIT | FLAGGED_BIT)) return;
+
+            cells[adj] |= REVEALED_BIT;
+            changed[changedCount++] = adj;
+            revealedCount++;
+            if ((cells[adj] & ADJACENT_MASK) == 0) {
+                workStack[stackSize++] = adj;
+            }
+        });
+    }
+    trace.setArg("tiles", static_cast<int64_t>(changedCount - changedBefore));
+}
+
+bool Board::reveal(int cell) {
+    SessionTrace::Scope trace("reveal", "board");
+    trace.setArg("cell", cell);
+    changedCount = 0;
+    if (lost || isWon()) return false;
+
+    revealArea(cell);
+    return changedCount > 0;
+}
+
+bool Board::toggleFlag(int cell) {
+    changedCount = 0;
+    if (lost || isWon() || (cells[cell] & REVEALED_BIT)) return false;
+
+    cells[cell] ^= FLAGGED_BIT;
+    flagCount += (cells[cell] & FLAGGED_BIT) ? 1 : -1;
+    changed[changedCount++] = cell;
+    return true;
+}
+
+// chord: if a revealed number has exactly that many flags around it, open every other neighbour at once
+bool Board::chord(int cell) {
+    SessionTrace::Scope trace("chord", "board");
+    trace.setArg("cell", cell);
+    changedCount = 0;
+    if (lost || isWon()) return false;
+
+    int adjacentMines = cells[cell] & ADJACENT_MASK;
+    if (!(cells[cell] & REVEALED_BIT) || adjacentMines == 0) return false;
+
+    int flagsAround = 0;
+    forEachNeighbour(cell, colCount, rowCount, [&](int adj) {
+        if (cells[adj] & FLAGGED_BIT) flagsAround++;
+    });
+    if (flagsAround != adjacentMines) return false;
+
+    // keep going after a mine so the rest of the chord still opens like a normal chord would
+    forEachNeighbour(cell, colCount, rowCount, [&](int adj) {
+        revealArea(adj);
+    });
+    return changedCount > 0;
+}
+
+void Board::toggleCells(const vector<int>& cellList, uint8_t bit) {
+    // undo lists hold each tile once, so they fit the changed list
+    changedCount = min(cellList.size(), static_cast<size_t>(getCellCount()));
+    copy(cellList.begin(), cellList.begin() + changedCount, changed);
+
+    for (int cell : cellList) {
+        cells[cell] ^= bit;
+        bool nowSet = cells[cell] & bit;
+
+        if (bit == FLAGGED_BIT) {
+            flagCount += nowSet ? 1 : -1;
+        } else if (cells[cell] & MINE_BIT) {
+            lost = nowSet; // only the losing action reveals mines
+        } else {
+            revealedCount += nowSet ? 1 : -1;
+        }
+    }
+}
+
+void Board::saveSnapshot(BoardSnapshot& snapshot) const {
+    snapshot.cells.assign(cells, cells + getCellCount());
+    snapshot.revealedCount = revealedCount;
+    snapshot.flagCount = flagCount;
+    snapshot.lost = lost;
+}
+
+void Board::loadSnapshot(const BoardSnapshot& snapshot) {
+    memcpy(cells, snapshot.cells.data(), snapshot.cells.size());
+    revealedCount = snapshot.revealedCount;
+    flagCount = snapshot.flagCount;
+    lost = snapshot.lost;
+    changedCount = 0;
+}
@@ -0,0 +1,125 @@
+/*
+purpose: headless minesweeper engine, all the game rules with no SFML
+
+implementation:
+- stores the whole board as one flat array of bytes, one per tile
+  (low 4 bits = adjacent mine count, then mine / revealed / flagged bits)
+- generates mines from a seed so the same seed always gives the same board
+- computes 3BV once at generation time
+- handles reveal (with flood fill of openings), flag and chord actions
+- tracks revealed / flag counts so win & loss checks are O(1)
+- remembers which tiles the last action changed so the UI only updates those
+- can save/load snapshots of its state (replay keyframes)
+- can flip a bit on a list of tiles (practice mode undo/redo, see UndoHistory.h)
+- the cell array either lives in the board's GameArena, or directly inside a
+  memory-mapped save file (resume without copying or parsing the tiles)
+- per-game memory (tiles, flood fill stack, changed list) comes from the GameArena, sized
+  for the worst case once per game (a tile is pushed / changed at most once per action),
+  so actions never grow anything, and the next generate() / attachCells() releases it all
+  with one reset
+
+used by GameScene for the real game and by the replay verifier to re-simulate games
+*/
+
+#ifndef BOARD_H
+#define BOARD_H
+
+#include "MappedFile.h"
+#include "GameArena.h"
+#include <vector>
+#include <cstdint>
+using namespace std;
+
+// full copy of a board's changing state, used for replay keyframes
+struct BoardSnapshot {
+    vector<uint8_t> cells;
+    int revealedCount;
+    int flagCount;
+    bool lost;
+};
+
+// tiles touched by the last action, a view into the board's arena (valid until the next action / game)
+struct CellList {
+    const int* first;
+    size_t count;
+
+    const int* begin() const { return first; }
+    const int* end() const { return first + count; }
+    size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+    int operator[](size_t i) const { return first[i]; }
+};
+
+class Board {
+public:
+    static const uint8_t ADJACENT_MASK = 0x0f;
+    static const uint8_t MINE_BIT = 0x10;
+    static const uint8_t REVEALED_BIT = 0x20;
+    static const uint8_t FLAGGED_BIT = 0x40;
+    // biggest board (tiles per row / column): a 32768 px wide window is already far past any
+    // screen, and it bounds what a replay can make the verifier allocate (~9 bytes a tile)
+    static constexpr int MAX_SIDE = 1024;
+
+private:
+    int colCount;
+    int rowCount;
+    int mineCount;
+    int revealedCount; // safe tiles revealed
+    int flagCount;
+    int bbbv;
+    bool lost;
+
+    GameArena arena;       // this game's memory, reset by the next game
+    uint8_t* cells;        // points into the arena or mappedCells
+    MappedFile mappedCells;
+    int* workStack;        // flood fill stack, one slot per tile
+    int* changed;          // tiles touched by the last action, one slot per tile
+    size_t changedCount;
+
+    void placeMines(uint64_t seed);
+    void calculateAdjacentMines();
+    void calculateBBBV();
+    void revealArea(int cell);
+    void allocateScratch();
+
+public:
+    Board();
+
+    void generate(int colCount, int rowCount, int mineCount, uint64_t seed);
+
+    // use cells stored at `offset` inside a mapped save file as this board's tiles (counters come from the save)
+    void attachCells(MappedFile&& storage, size_t offset, int colCount, int rowCount, int mineCount,
+                     int revealedCount, int flagCount, int bbbv, bool lost);
+    const uint8_t* getCells() const { return cells; }
+
+    // actions, each returns true if the board changed
+    bool reveal(int cell);
+    bool toggleFlag(int cell);
+    bool chord(int cell);
+
+    // flip `bit` (REVEALED_BIT or FLAGGED_BIT) on each tile and fix the counters, used by undo/redo
+    void toggleCells(const vector<int>& cellList, uint8_t bit);
+
+    void saveSnapshot(BoardSnapshot& snapshot) const;
+    void loadSnapshot(const BoardSnapshot& snapshot);
+
+    // getters
+    int getColCount() const { return colCount; }
+    int getRowCount() const { return rowCount; }
+    int getMineCount() const { return mineCount; }
+    int getCellCount() const { return colCount * rowCount; }
+    int getFlagCount() const { return flagCount; }
+    int getRevealedCount() const { return revealedCount; }
+    int getBBBV() const { return bbbv; }
+    bool isLost() const { return lost; }
+    bool isWon() const { return !lost && revealedCount == getCellCount() - mineCount; }
+
+    bool isMine(int cell) const { return cells[cell] & MINE_BIT; }
+    bool isRevealed(int cell) const { return cells[cell] & REVEALED_BIT; }
+    bool isFlagged(int cell) const { return cells[cell] & FLAGGED_BIT; }
+    int getAdjacentMines(int cell) const { return cells[cell] & ADJACENT_MASK; }
+    CellList getChanged() const { return {changed, changedCount}; }
+    const GameArena& getArena() const { return arena; }
+};
+
+#endif
@@ -0,0 +1,25 @@
+/*
+key components:
+- constructor: opens (creating if needed) the lock file and blocks in flock until it's ours
+- destructor: unlock + close
+*/
+
+#include "FileLock.h"
+#include <iostream>
+#include <sys/file.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+FileLock::FileLock(const string& path, bool exclusive) {
+    fd = ::open(path.c_str(), O_RDWR | O_CREAT, 0644);
+    if (fd >= 0 && flock(fd, exclusive ? LOCK_EX : LOCK_SH) != 0) {
+        cerr << "Failed to lock " << path << endl;
+    }
+}
+
+FileLock::~FileLock() {
+    if (fd >= 0) {
+        flock(fd, LOCK_UN);
+        ::close(fd);
+    }
+}
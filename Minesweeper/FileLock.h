@@ -0,0 +1,27 @@
+/*
+purpose: advisory whole-file lock shared between game processes (and the leaderboard daemon)
+
+implementation:
+- flock() on a small side file (e.g. leaderboard.lock) rather than the data file itself,
+  so the data file can be replaced by rename while someone holds the lock
+- shared for readers, exclusive for writers, released when the object goes out of scope
+*/
+
+#ifndef FILELOCK_H
+#define FILELOCK_H
+
+#include <string>
+using namespace std;
+
+class FileLock {
+private:
+    int fd;
+
+public:
+    FileLock(const string& path, bool exclusive);
+    ~FileLock();
+    FileLock(const FileLock&) = delete;
+    FileLock& operator=(const FileLock&) = delete;
+};
+
+#endif
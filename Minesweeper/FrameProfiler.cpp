@@ -0,0 +1,216 @@
+/*
+key components:
+- Scope: reads the clock only when the profiler is enabled, adds the elapsed ms to the phase
+  (a phase can be entered more than once a frame, it sums)
+- beginFrame: closes the previous frame (frame time, ring + histogram, refresh sums),
+  refreshes the overlay text + bars when REFRESH_MILLIS have passed, starts the next frame
+- refresh: per phase averages, average draw calls / vertices, p50 / p99 / max over the ring
+- costOf: what SFML 2.6 sends for each drawable type (sf::Text skips whitespace, outlines are
+  a second call), empty geometry is no draw call
+- drawOverlay: background, text and the histogram bars (one vertex array), the overlay's own draw
+  calls aren't counted
+*/
+
+#include "FrameProfiler.h"
+#include <algorithm>
+#include <cstdio>
+
+static const char* const PHASE_NAMES[] = {"events", "updateTimer", "drawBoard", "drawUI", "display"};
+static_assert(sizeof(PHASE_NAMES) / sizeof(PHASE_NAMES[0]) == static_cast<size_t>(FramePhase::Count), "one name per FramePhase");
+
+static const float OVERLAY_X = 4;
+static const float OVERLAY_Y = 4;
+static const float OVERLAY_WIDTH = 250;
+static const float TEXT_HEIGHT = 150;
+static const float BAR_WIDTH = 11;
+static const float BAR_HEIGHT = 40;
+
+FrameProfiler::Scope::Scope(FrameProfiler& profiler, FramePhase phase)
+    : profiler(profiler), phase(phase), running(profiler.enabled) {
+    if (running) {
+        start = chrono::steady_clock::now();
+    }
+}
+
+FrameProfiler::Scope::~Scope() {
+    end();
+}
+
+void FrameProfiler::Scope::end() {
+    if (running && profiler.enabled) {
+        profiler.phaseMillis[static_cast<size_t>(phase)] += chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+    }
+    running = false;
+}
+
+FrameProfiler::FrameProfiler(const sf::Font& font)
+    : enabled(false), frameStarted(false), histogram(sf::Triangles, BUCKET_COUNT * 6) {
+    background.setPosition(OVERLAY_X, OVERLAY_Y);
+    background.setSize(sf::Vector2f(OVERLAY_WIDTH, TEXT_HEIGHT + BAR_HEIGHT + 12));
+    background.setFillColor(sf::Color(0, 0, 0, 190));
+    text.setFont(font);
+    text.setCharacterSize(13);
+    text.setFillColor(sf::Color(255, 255, 255));
+    text.setPosition(OVERLAY_X + 6, OVERLAY_Y + 4);
+    setEnabled(false);
+}
+
+void FrameProfiler::setEnabled(bool on) {
+    enabled = on;
+    // start clean, the time spent disabled isn't a frame
+    frameStarted = false;
+    phaseMillis.fill(0);
+    phaseSums.fill(0);
+    frameSum = 0;
+    drawCalls = vertexCount = 0;
+    drawCallSum = vertexSum = 0;
+    sampledFrames = 0;
+    frameCount = nextFrame = 0;
+    buckets.fill(0);
+    lastRefresh = chrono::steady_clock::now();
+    if (on) {
+        text.setString("measuring...");
+        refresh();
+    }
+}
+
+size_t FrameProfiler::bucketOf(float frameMillis) {
+    size_t bucket = static_cast<size_t>(max(0.0f, frameMillis) / 2);
+    return min(bucket, BUCKET_COUNT - 1);
+}
+
+void FrameProfiler::recordFrame(double frameMillis) {
+    if (frameCount == FRAME_HISTORY) {
+        buckets[bucketOf(frameTimes[nextFrame])]--; // oldest falls out of the window
+    } else {
+        frameCount++;
+    }
+    frameTimes[nextFrame] = static_cast<float>(frameMillis);
+    buckets[bucketOf(frameTimes[nextFrame])]++;
+    nextFrame = (nextFrame + 1) % FRAME_HISTORY;
+
+    for (size_t i = 0; i < PHASE_COUNT; ++i) {
+        phaseSums[i] += phaseMillis[i];
+    }
+    frameSum += frameMillis;
+    drawCallSum += drawCalls;
+    vertexSum += vertexCount;
+    sampledFrames++;
+}
+
+void FrameProfiler::beginFrame() {
+    if (!enabled) {
+        return;
+    }
+    auto now = chrono::steady_clock::now();
+    if (frameStarted) {
+        recordFrame(chrono::duration<double, milli>(now - frameStart).count());
+    }
+    if (chrono::duration<double, milli>(now - lastRefresh).count() >= REFRESH_MILLIS) {
+        refresh();
+        lastRefresh = now;
+    }
+    frameStart = now;
+    frameStarted = true;
+    phaseMillis.fill(0);
+    drawCalls = vertexCount = 0;
+}
+
+void FrameProfiler::refresh() {
+    char buffer[512];
+    int length = 0;
+    if (sampledFrames > 0) {
+        double frames = sampledFrames;
+        double frameAverage = frameSum / frames;
+        double other = frameAverage;
+        length += snprintf(buffer + length, sizeof(buffer) - length, "frame %6.2f ms (%.0f fps)\n",
+                           frameAverage, frameAverage > 0 ? 1000 / frameAverage : 0.0);
+        for (size_t i = 0; i < PHASE_COUNT; ++i) {
+            double average = phaseSums[i] / frames;
+            other -= average;
+            length += snprintf(buffer + length, sizeof(buffer) - length, "  %-11s %6.2f ms\n", PHASE_NAMES[i], average);
+        }
+        length += snprintf(buffer + length, sizeof(buffer) - length, "  %-11s %6.2f ms\n", "other", max(0.0, other));
+        length += snprintf(buffer + length, sizeof(buffer) - length, "draws %llu  vertices %llu\n",
+                           drawCallSum / sampledFrames, vertexSum / sampledFrames);
+    }
+    if (frameCount > 0) {
+        copy(frameTimes.begin(), frameTimes.begin() + frameCount, sortScratch.begin());
+        auto first = sortScratch.begin();
+        auto last = sortScratch.begin() + frameCount;
+        auto p50 = first + (frameCount - 1) / 2;
+        nth_element(first, p50, last);
+        float median = *p50;
+        auto p99 = first + (frameCount - 1) * 99 / 100;
+        nth_element(p50, p99, last); // everything before p50 is already smaller
+        float maxTime = *max_element(p99, last);
+        snprintf(buffer + length, sizeof(buffer) - length, "p50 %.2f  p99 %.2f  max %.2f ms\nlast %zu frames, 2 ms buckets:",
+                 median, *p99, maxTime, frameCount);
+        text.setString(buffer);
+    }
+    phaseSums.fill(0);
+    frameSum = 0;
+    drawCallSum = vertexSum = 0;
+    sampledFrames = 0;
+
+    // histogram bars, tallest bucket = full height
+    unsigned tallest = max(1u, *max_element(buckets.begin(), buckets.end()));
+    float baseline = OVERLAY_Y + TEXT_HEIGHT + BAR_HEIGHT + 6;
+    for (size_t i = 0; i < BUCKET_COUNT; ++i) {
+        float height = BAR_HEIGHT * buckets[i] / tallest;
+        float left = OVERLAY_X + 6 + i * (BAR_WIDTH + 1);
+        float right = left + BAR_WIDTH;
+        sf::Color color = i < 9 ? sf::Color(90, 200, 90) : i < 17 ? sf::Color(230, 200, 60) : sf::Color(230, 70, 60); // <= 16.7 ms / 33 ms / more
+        sf::Vertex* quad = &histogram[i * 6];
+        quad[0] = sf::Vertex(sf::Vector2f(left, baseline - height), color);
+        quad[1] = sf::Vertex(sf::Vector2f(right, baseline - height), color);
+        quad[2] = sf::Vertex(sf::Vector2f(left, baseline), color);
+        quad[3] = quad[2];
+        quad[4] = quad[1];
+        quad[5] = sf::Vertex(sf::Vector2f(right, baseline), color);
+    }
+}
+
+FrameProfiler::DrawCost FrameProfiler::costOf(const sf::Sprite&) {
+    return {1, 4};
+}
+
+FrameProfiler::DrawCost FrameProfiler::costOf(const sf::Text& text) {
+    const sf::String& string = text.getString();
+    unsigned glyphs = 0;
+    for (size_t i = 0; i < string.getSize(); ++i) {
+        sf::Uint32 c = string[i];
+        if (c != ' ' && c != '\n' && c != '\t') {
+            glyphs++;
+        }
+    }
+    if (glyphs == 0) {
+        return {0, 0};
+    }
+    bool outlined = text.getOutlineThickness() != 0;
+    return {outlined ? 2u : 1u, glyphs * 6 * (outlined ? 2 : 1)};
+}
+
+FrameProfiler::DrawCost FrameProfiler::costOf(const sf::Shape& shape) {
+    unsigned points = shape.getPointCount();
+    DrawCost cost = {1, points + 2}; // triangle fan: centre, the points, the first point again
+    if (shape.getOutlineThickness() != 0) {
+        cost.calls++;
+        cost.vertices += (points + 1) * 2; // triangle strip around it
+    }
+    return cost;
+}
+
+FrameProfiler::DrawCost FrameProfiler::costOf(const sf::VertexArray& vertices) {
+    unsigned count = vertices.getVertexCount();
+    return {count > 0 ? 1u : 0u, count};
+}
+
+void FrameProfiler::drawOverlay(sf::RenderTarget& target) {
+    if (!enabled) {
+        return;
+    }
+    target.draw(background);
+    target.draw(text);
+    target.draw(histogram);
+}
@@ -0,0 +1,129 @@
+/*
+purpose: per-frame timing of the main loop with an on-screen overlay, to find frame spikes
+on big boards without attaching a profiler (the "perf" button under the debug button, or F3)
+
+implementation:
+- the SceneStack owns one and marks the frame boundaries; the phases are timed by scope
+  timers where they happen: events + display in SceneStack::run, updateTimer / drawBoard /
+  drawUI in the game scene, whatever is left of the frame shows up as "other"
+- draw calls and vertices are counted where they're issued: every scene draws through
+  draw(target, drawable), which asks the drawable itself what it's about to send (a sprite
+  is 4 vertices, text 6 per visible glyph, a shape its fan + outline strip, a vertex array
+  its size), so nothing is a hand-kept total; only types with a cost overload compile
+- frame time is start of frame to start of the next (so it includes display / vsync);
+  the last FRAME_HISTORY frame times are kept in a ring, with a bucket count per 2 ms kept
+  in step, which is the histogram
+- the overlay text (phase averages, p50 / p99 / max) is refreshed REFRESH_MILLIS apart, not
+  every frame, percentiles use nth_element on a fixed scratch array
+- disabled (the default) a scope timer or a counted draw's counting is one bool test, no clock reads,
+  beginFrame does nothing, so it can stay compiled into release builds
+*/
+
+#ifndef FRAMEPROFILER_H
+#define FRAMEPROFILER_H
+
+#include <SFML/Graphics.hpp>
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+using namespace std;
+
+enum class FramePhase : uint8_t {
+    Events, UpdateTimer, DrawBoard, DrawUI, Display,
+    Count
+};
+
+class FrameProfiler {
+public:
+    static const size_t FRAME_HISTORY = 300;   // ~5 s at 60 fps
+    static const size_t BUCKET_COUNT = 20;     // 2 ms each, the last one is 38 ms and up
+    static const int REFRESH_MILLIS = 250;
+
+    // what one drawable sends to the GPU
+    struct DrawCost {
+        unsigned calls;
+        unsigned vertices;
+    };
+
+    // times the enclosing scope (or until end()) as one phase of the current frame
+    class Scope {
+    private:
+        FrameProfiler& profiler;
+        FramePhase phase;
+        bool running;
+        chrono::steady_clock::time_point start;
+
+    public:
+        Scope(FrameProfiler& profiler, FramePhase phase);
+        ~Scope();
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+        void end();
+    };
+
+private:
+    static const size_t PHASE_COUNT = static_cast<size_t>(FramePhase::Count);
+
+    bool enabled;
+
+    // the frame being measured
+    chrono::steady_clock::time_point frameStart;
+    bool frameStarted;
+    array<double, PHASE_COUNT> phaseMillis;
+    unsigned drawCalls;
+    unsigned vertexCount;
+
+    // since the last refresh, for averages
+    array<double, PHASE_COUNT> phaseSums;
+    double frameSum;
+    unsigned long long drawCallSum;
+    unsigned long long vertexSum;
+    unsigned sampledFrames;
+    chrono::steady_clock::time_point lastRefresh;
+
+    // rolling frame times + histogram
+    array<float, FRAME_HISTORY> frameTimes;
+    array<float, FRAME_HISTORY> sortScratch;
+    size_t frameCount;  // valid entries in frameTimes
+    size_t nextFrame;   // ring write position
+    array<unsigned, BUCKET_COUNT> buckets;
+
+    // overlay
+    sf::RectangleShape background;
+    sf::Text text;
+    sf::VertexArray histogram;
+
+    void recordFrame(double frameMillis);
+    void refresh();
+    static size_t bucketOf(float frameMillis);
+
+public:
+    explicit FrameProfiler(const sf::Font& font);
+
+    bool isEnabled() const { return enabled; }
+    void setEnabled(bool on);
+    void toggle() { setEnabled(!enabled); }
+
+    void beginFrame(); // SceneStack, top of every loop iteration
+
+    // every scene draw goes through here: draws it and counts its draw calls + vertices
+    template <typename T>
+    void draw(sf::RenderTarget& target, const T& drawable, const sf::RenderStates& states = sf::RenderStates::Default) {
+        if (enabled) {
+            DrawCost cost = costOf(drawable);
+            drawCalls += cost.calls;
+            vertexCount += cost.vertices;
+        }
+        target.draw(drawable, states);
+    }
+    static DrawCost costOf(const sf::Sprite& sprite);
+    static DrawCost costOf(const sf::Text& text);
+    static DrawCost costOf(const sf::Shape& shape);
+    static DrawCost costOf(const sf::VertexArray& vertices);
+
+    // the overlay in the top left corner of the target (call last, before display)
+    void drawOverlay(sf::RenderTarget& target);
+};
+
+#endif
@@ -0,0 +1,56 @@
+/*
+key components:
+- allocate: align the offset, bump it if the block has room, otherwise an overflow block
+  (over-allocated by the alignment so the pointer can be aligned inside it)
+- reset: one offset store; after an overflow, one new block sized for the whole game
+*/
+
+#include "GameArena.h"
+#include <algorithm>
+
+// the first game's block, a 30x16 board with its scratch arrays fits easily
+static const size_t INITIAL_CAPACITY = 16 * 1024;
+
+static size_t alignUp(size_t value, size_t alignment) {
+    return (value + alignment - 1) & ~(alignment - 1);
+}
+
+GameArena::GameArena() : capacity(0), used(0), overflowBytes(0), systemAllocations(0) {}
+
+void* GameArena::allocate(size_t bytes, size_t alignment) {
+    size_t start = alignUp(used, alignment);
+    if (block && start + bytes <= capacity) {
+        used = start + bytes;
+        return block.get() + start;
+    }
+
+    if (!block && overflow.empty()) {
+        // first use: a main block, big enough for this request too
+        capacity = max(INITIAL_CAPACITY, alignUp(bytes, alignment));
+        block.reset(new uint8_t[capacity]);
+        systemAllocations++;
+        used = bytes;
+        return block.get();
+    }
+
+    overflow.emplace_back(new uint8_t[bytes + alignment]);
+    systemAllocations++;
+    overflowBytes += bytes + alignment;
+    uintptr_t address = reinterpret_cast<uintptr_t>(overflow.back().get());
+    return reinterpret_cast<void*>(alignUp(address, alignment));
+}
+
+void GameArena::reset() {
+    if (!overflow.empty()) {
+        // the game outgrew the block: next time the whole game goes in one block
+        size_t needed = alignUp(used + overflowBytes, 4096);
+        overflow.clear();
+        overflowBytes = 0;
+        if (needed > capacity) {
+            block.reset(new uint8_t[needed]);
+            capacity = needed;
+            systemAllocations++;
+        }
+    }
+    used = 0;
+}
@@ -0,0 +1,59 @@
+/*
+purpose: per-game bump allocator: everything a game's Board needs (tiles, flood fill stack,
+changed tile list) comes out of one block and is released in one go when the next game
+starts, so simulating millions of games never goes back to the general allocator
+
+implementation:
+- allocate() rounds the offset up to the alignment and bumps it, no per-allocation header,
+  nothing is freed individually (only trivially destructible types, no destructors run)
+- a request that doesn't fit takes a separate overflow block, pointers already handed
+  out stay valid; reset() then drops the overflow and grows the main block to what the
+  whole game needed, so from the next game on it all fits in one block again
+- reset() is O(1) when nothing overflowed: the offset goes back to 0, the block is kept
+- getSystemAllocations() counts trips to operator new, a steady batch run should see it
+  stop moving after the first game
+*/
+
+#ifndef GAMEARENA_H
+#define GAMEARENA_H
+
+#include <memory>
+#include <vector>
+#include <type_traits>
+#include <cstddef>
+#include <cstdint>
+using namespace std;
+
+class GameArena {
+private:
+    unique_ptr<uint8_t[]> block;
+    size_t capacity;
+    size_t used;
+    vector<unique_ptr<uint8_t[]>> overflow; // this game's blocks that didn't fit in `block`
+    size_t overflowBytes;
+    uint64_t systemAllocations;
+
+public:
+    GameArena();
+    GameArena(const GameArena&) = delete;
+    GameArena& operator=(const GameArena&) = delete;
+    GameArena(GameArena&&) = default;
+    GameArena& operator=(GameArena&&) = default;
+
+    void* allocate(size_t bytes, size_t alignment);
+
+    template <typename T>
+    T* allocate(size_t count) {
+        static_assert(is_trivially_destructible<T>::value, "the arena never runs destructors");
+        return static_cast<T*>(allocate(count * sizeof(T), alignof(T)));
+    }
+
+    // everything allocated so far is gone (the next game starts)
+    void reset();
+
+    size_t getUsed() const { return used + overflowBytes; }
+    size_t getCapacity() const { return capacity; }
+    uint64_t getSystemAllocations() const { return systemAllocations; }
+};
+
+#endif
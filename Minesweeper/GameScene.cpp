@@ -0,0 +1,913 @@
+/*
+key components:
+- contructor: sets up the game scene in the stack's window, board, and init all elememts 
+  (the player's constructor resumes or starts a game, the viewer one only loads the replay)
+- resource mangement: textures + font come from the ResourceCache (by TextureId), set up sprites 
+- board setup: generates the Board (mines, adjacent counts, 3BV) and builds the tile grid from it
+- game logic: tile actions go through the headless Board, changed tiles are synced back, victory/defeat 
+- UI management: buttons, counter, window events 
+- event handling: processes mouse clicks & key events handed over by the SceneStack
+- leaderboard: pauses the game and pushes a LeaderboardScene, onResume undoes the pause
+- drawing: renders the game board and UI elements 
+- timer & counter: manages game time tracking and mines remaining display 
+- save / resume: unfinished games are saved on close and resumed from a mapped save file,
+  every move also goes to the crash journal so a crash loses at most the journal lag
+- practice mode: every action's changed tiles go into an UndoHistory, undo/redo only resync those
+- replay mode: drives a ReplayPlayer from the frame clock, resyncs tiles after seeks
+*/
+
+#include <iostream>
+#include <fstream>
+#include <ctime>
+#include <random>
+#include <sstream>
+#include <algorithm>
+#include "GameScene.h"
+#include "SaveGame.h"
+#include "SessionTrace.h"
+#include <filesystem>
+#include <cstdio>
+
+GameScene::GameScene(SceneStack& stack, int colCount, int rowCount, int mineCount, const string& playerName, int journalLagMillis)
+    : GameScene(stack, colCount, rowCount, mineCount, playerName, false) {
+    journal.setLag(journalLagMillis);
+    if (!resumeGame()) {
+        newGame();
+    }
+    SessionTrace::finishStartupOnNextFrame(); // the first frame with the board on it ends startup
+}
+
+// watching only: no resume, no journal, no save, the replay player's own game is left alone
+GameScene::GameScene(SceneStack& stack, const Replay& replay)
+    : GameScene(stack, replay.header.colCount, replay.header.rowCount, replay.header.mineCount, replay.header.playerName, true) {
+    playReplay(replay);
+    SessionTrace::finishStartupOnNextFrame();
+}
+
+GameScene::GameScene(SceneStack& stack, int colCount, int rowCount, int mineCount, const string& playerName, bool viewerOnly)
+    : Scene(stack), window(stack.getWindow()), colCount(colCount), rowCount(rowCount), mineCount(mineCount), playerName(playerName),
+    gameOver(false), gameWon(false), debugMode(false), paused(false), flagCount(0),
+    elapsedSeconds(0), timerRunning(false), ownsSave(false), practiceMode(false), practiceAsked(false), viewerOnly(viewerOnly), replayMode(false), replayPlaying(false), replaySpeed(1.0f), replayTime(0), busyThisFrame(false),
+    leaderboardWasPaused(false), leaderboardStoppedTimer(false), resources(ResourceCache::get()), font(stack.getFont()),
+    profiler(stack.getProfiler()) {
+    SessionTrace::Scope trace("game scene", SessionTrace::STARTUP);
+
+    // output to verify constructor parameters (debugging)
+    // std::cout << "GameScene constructor called with:" << std::endl;
+    // std::cout << "  colCount: " << colCount << std::endl;
+    // std::cout << "  rowCount: " << rowCount << std::endl;
+    // std::cout << "  mineCount: " << mineCount << std::endl;
+    // std::cout << "  playerName: " << playerName << std::endl;
+
+    window.setTitle("Minesweeper");
+
+    counterDigits.resize(3);
+    timerDigits.resize(4);
+
+    loadTextures();
+}
+
+// generate a fresh seeded board and start the timer + replay for it
+void GameScene::newGame() {
+    random_device device;
+    seed = (static_cast<uint64_t>(device()) << 32) ^ static_cast<uint64_t>(time(nullptr)) ^ device();
+
+    board.generate(colCount, rowCount, mineCount, seed);
+    setupBoard();
+
+    history.clear();
+    if (!practiceMode) {
+        recorder.begin({seed, colCount, rowCount, mineCount, playerName});
+        journal.begin(journalPath(), Journal::makeHeader(false, 0, seed, colCount, rowCount, mineCount));
+        if (ownsSave) {
+            journal.removeFile(savePath()); // the save is for the game we've now moved on from
+            ownsSave = false;
+        }
+    }
+
+    startTime = chrono::high_resolution_clock::now();
+    timerRunning = true;
+}
+
+// game time in ms (pauses excluded since startTime gets pushed forward on resume)
+uint32_t GameScene::currentTick() const {
+    return static_cast<uint32_t>(chrono::duration_cast<chrono::milliseconds>(chrono::high_resolution_clock::now() - startTime).count());
+}
+
+// one save + journal per player and board, so playing another board size never touches this one's
+string GameScene::savePath() const {
+    return "saves/" + playerName + "_" + to_string(colCount) + "x" + to_string(rowCount) + "_" + to_string(mineCount) + ".msv";
+}
+
+string GameScene::journalPath() const {
+    return "saves/" + playerName + "_" + to_string(colCount) + "x" + to_string(rowCount) + "_" + to_string(mineCount) + ".journal";
+}
+
+// saves from before they were kept per board (saves/<player>.msv + .journal) move to their
+// board's names the first time that board is played, any other board leaves them where they are
+void GameScene::adoptOldSave() {
+    string oldSave = "saves/" + playerName + ".msv";
+    string oldJournal = "saves/" + playerName + ".journal";
+    error_code ec;
+    if (filesystem::exists(savePath(), ec) || filesystem::exists(journalPath(), ec)) {
+        return;
+    }
+
+    // the journal says what it builds on, without one the save header does
+    int oldCols = 0, oldRows = 0, oldMines = 0;
+    JournalHeader journalHeader;
+    vector<ReplayMove> journalMoves;
+    SaveHeader saveHeader;
+    ifstream save(oldSave, ios::binary);
+    if (Journal::read(oldJournal, journalHeader, journalMoves)) {
+        oldCols = journalHeader.colCount;
+        oldRows = journalHeader.rowCount;
+        oldMines = journalHeader.mineCount;
+    } else if (save.read(reinterpret_cast<char*>(&saveHeader), sizeof(saveHeader))) {
+        oldCols = saveHeader.colCount;
+        oldRows = saveHeader.rowCount;
+        oldMines = saveHeader.mineCount;
+    }
+    save.close();
+    if (oldCols != colCount || oldRows != rowCount || oldMines != mineCount) {
+        return;
+    }
+
+    filesystem::rename(oldSave, savePath(), ec);
+    filesystem::rename(oldJournal, journalPath(), ec);
+}
+
+// write the whole current game to the save file
+bool GameScene::writeSave(uint32_t elapsedMillis) {
+    SavedGame game;
+    game.playerName = playerName;
+    game.seed = seed;
+    game.elapsedMillis = elapsedMillis;
+    game.replayBytes = recorder.gameSoFar();
+    game.replayLastTick = recorder.getLastTick();
+    game.replayLastCell = recorder.getLastCell();
+    game.replayMoveCount = recorder.getMoveCount();
+
+    error_code ec;
+    filesystem::create_directories("saves", ec);
+    if (!saveGame(savePath(), board, game)) {
+        return false;
+    }
+    ownsSave = true;
+    return true;
+}
+
+// game is over (or abandoned), nothing left to recover
+void GameScene::endJournal() {
+    journal.discard();
+    if (ownsSave) {
+        journal.removeFile(savePath());
+        ownsSave = false;
+    }
+}
+
+// called when the window closes mid game
+bool GameScene::saveCurrentGame() {
+    if (gameOver || replayMode || practiceMode || recorder.getMoveCount() == 0) {
+        return true; // nothing worth resuming
+    }
+
+    auto endTime = paused ? pauseTime : chrono::high_resolution_clock::now();
+    uint32_t elapsedMillis = static_cast<uint32_t>(chrono::duration_cast<chrono::milliseconds>(endTime - startTime).count());
+    if (writeSave(elapsedMillis)) {
+        journal.discard(); // everything in it is in the save now
+        return true;
+    }
+    cerr << "Failed to save game :( (the journal can still recover it)" << endl;
+    return false;
+}
+
+// P: the ranked game in progress is parked in the save (journal closed) before practice starts,
+// so practice moves never reach the ranked journal / save, and leaving practice resumes it
+void GameScene::togglePractice() {
+    if (practiceMode) {
+        practiceMode = false;
+        resetGame(true);
+        return;
+    }
+
+    if (!gameOver && recorder.getMoveCount() > 0) {
+        auto now = chrono::high_resolution_clock::now();
+        if (!practiceAsked || now - practiceAskedTime > chrono::milliseconds(PRACTICE_CONFIRM_MILLIS)) {
+            practiceAsked = true;
+            practiceAskedTime = now;
+            window.setTitle("Minesweeper - press P again to practice (this game is saved for later)");
+            return;
+        }
+        practiceAsked = false;
+        if (!saveCurrentGame()) {
+            window.setTitle("Minesweeper");
+            cerr << "Staying in the ranked game since it couldn't be saved" << endl;
+            return;
+        }
+    } else {
+        journal.discard(); // the ranked game hasn't started (or is over), nothing to keep
+    }
+
+    practiceMode = true;
+    resetGame();
+}
+
+// rebuild an unfinished game from the save file (window was closed) and/or the journal (game crashed)
+// the save is only removed once it has been read and found unusable (corrupt or already finished),
+// saves for other board sizes are other files and never looked at
+bool GameScene::resumeGame() {
+    adoptOldSave();
+    JournalHeader journalHeader;
+    vector<ReplayMove> journalMoves;
+    bool haveJournal = Journal::read(journalPath(), journalHeader, journalMoves);
+    bool fromSave = haveJournal ? journalHeader.fromSave != 0 : filesystem::exists(savePath());
+
+    SavedGame game;
+    game.elapsedMillis = 0;
+    if (fromSave) {
+        if (!loadGame(savePath(), board, game) || game.playerName != playerName) {
+            cerr << "Saved game is corrupt, removing it and starting a new one" << endl;
+            journal.removeFile(savePath());
+            return false;
+        }
+        // the journal (if any) must continue exactly where the save ends
+        if (haveJournal && game.replayMoveCount != journalHeader.baseMoveCount) {
+            cerr << "Crash journal does not continue the saved game, starting a new one" << endl;
+            return false;
+        }
+        ownsSave = true;
+        seed = game.seed;
+        recorder.resume({seed, board.getColCount(), board.getRowCount(), board.getMineCount(), playerName},
+                        game.replayBytes, game.replayLastTick, game.replayLastCell, game.replayMoveCount);
+    } else if (haveJournal) {
+        if (journalHeader.colCount <= 0 || journalHeader.rowCount <= 0 || journalHeader.mineCount <= 0
+            || journalHeader.mineCount >= journalHeader.colCount * journalHeader.rowCount) {
+            return false;
+        }
+        seed = journalHeader.seed;
+        board.generate(journalHeader.colCount, journalHeader.rowCount, journalHeader.mineCount, seed);
+        recorder.begin({seed, journalHeader.colCount, journalHeader.rowCount, journalHeader.mineCount, playerName});
+    } else {
+        return false;
+    }
+
+    // the files are named after the board, so a different one inside means they're damaged
+    if (board.getColCount() != colCount || board.getRowCount() != rowCount || board.getMineCount() != mineCount) {
+        cerr << "Saved game is for a " << board.getColCount() << "x" << board.getRowCount()
+             << " board, not the one it's named for, removing it and starting a new one" << endl;
+        journal.removeFile(savePath());
+        ownsSave = false;
+        return false;
+    }
+
+    // redo every move the journal has past the base
+    uint32_t elapsedMillis = game.elapsedMillis;
+    for (const ReplayMove& move : journalMoves) {
+        if (move.cell >= static_cast<uint32_t>(board.getCellCount()) || board.isWon() || board.isLost()) {
+            break;
+        }
+        recorder.record(move.tick, move.cell, move.action);
+        applyMove(board, move);
+        elapsedMillis = max(elapsedMillis, move.tick);
+    }
+    if (board.isWon() || board.isLost()) {
+        endJournal(); // it had already finished, nothing to resume
+        return false;
+    }
+
+    mineCount = board.getMineCount();
+    setupBoard();
+    syncAllTiles();
+
+    // checkpoint the recovered game so the new journal can build on it
+    if (!journalMoves.empty() || !fromSave) {
+        writeSave(elapsedMillis);
+    }
+    journal.begin(journalPath(), Journal::makeHeader(true, recorder.getMoveCount(), seed, colCount, rowCount, mineCount));
+
+    gameOver = false;
+    gameWon = false;
+    paused = false;
+    startTime = chrono::high_resolution_clock::now() - chrono::milliseconds(elapsedMillis);
+    timerRunning = true;
+    return true;
+}
+
+void GameScene::loadTextures() {
+    // loaded once per process, a second game scene just gets the same textures back
+    resources.preload();
+
+    // set up ui buttons 
+    faceButton.setTexture(resources.texture(TextureId::FaceHappy));
+    debugButton.setTexture(resources.texture(TextureId::Debug));
+    pauseButton.setTexture(resources.texture(TextureId::Pause));
+    leaderboardButton.setTexture(resources.texture(TextureId::Leaderboard));
+
+    // now we need to position the buttons 
+    float faceX = (colCount / 2.0f) * 32 - 32;
+    float faceY = 32 * (rowCount + 0.5f);
+    float debugX = (colCount * 32) - 304;
+    float debugY = 32 * (rowCount + 0.5f);
+    float pauseX = (colCount * 32) - 240;
+    float pauseY = 32 * (rowCount + 0.5f);
+    float leaderboardX = (colCount * 32) - 176;
+    float leaderboardY = 32 * (rowCount + 0.5f);
+
+    faceButton.setPosition(faceX, faceY);
+    debugButton.setPosition(debugX, debugY);
+    pauseButton.setPosition(pauseX, pauseY);
+    leaderboardButton.setPosition(leaderboardX, leaderboardY);
+
+    for (size_t i = 0; i < counterDigits.size(); ++i) {
+        counterDigits[i].setTexture(resources.texture(TextureId::Digits));
+        timerDigits[i].setTextureRect(sf::IntRect(0, 0, 21, 32));
+    }
+
+    for (size_t i = 0; i < timerDigits.size(); ++i) {
+        timerDigits[i].setTexture(resources.texture(TextureId::Digits));
+        timerDigits[i].setTextureRect(sf::IntRect(0, 0, 21, 32));
+    }
+
+    minusSign.setTexture(resources.texture(TextureId::Digits));
+    minusSign.setTextureRect(sf::IntRect(10*21, 0, 21, 32));
+    minusSign.setPosition(12, 32 * (rowCount + .5f) + 16);
+
+    // no texture for this one, a small labelled box in the strip under the debug button
+    profilerButton.setSize(sf::Vector2f(64, 16));
+    profilerButton.setPosition(debugX, debugY + 66);
+    profilerButton.setFillColor(sf::Color(200, 200, 200));
+    profilerButton.setOutlineColor(sf::Color(90, 90, 90));
+    profilerButton.setOutlineThickness(1);
+    profilerLabel.setFont(font);
+    profilerLabel.setString("perf");
+    profilerLabel.setCharacterSize(12);
+    profilerLabel.setFillColor(sf::Color(0, 0, 0));
+    profilerLabel.setPosition(debugX + 20, debugY + 66);
+}
+
+void GameScene::setupBoard() {
+    SessionTrace::Scope trace("setupBoard", SessionTrace::STARTUP);
+    tiles.resize(rowCount, vector<Tile>(colCount, Tile(0, 0, resources.texture(TextureId::TileHidden), resources.texture(TextureId::TileRevealed))));
+
+    // init every tile from the generated board
+    for (int row = 0; row < rowCount; ++row) {
+        for (int col = 0; col < colCount; ++col) {
+            float x = col * 32; // set x, y positions 
+            float y = row * 32;
+            int cell = row * colCount + col;
+
+            tiles[row][col] = Tile(row, col, resources.texture(TextureId::TileHidden), resources.texture(TextureId::TileRevealed));
+            tiles[row][col].setPosition(x, y);
+            tiles[row][col].setMineSprite(resources.texture(TextureId::Mine));
+            tiles[row][col].setFlagSprite(resources.texture(TextureId::Flag));
+            tiles[row][col].setMine(board.isMine(cell));
+
+            // update num sprite to match count 
+            int count = board.getAdjacentMines(cell);
+            tiles[row][col].setAdjacentMines(count);
+            if (count > 0) {
+                tiles[row][col].setNumberSprite(resources.number(count), count);
+            }
+        }
+    }
+
+    flagCount = 0;
+    for (size_t i = 0; i<counterDigits.size(); ++i) {
+        counterDigits[i].setPosition(33 + i*21, 32 * (rowCount + 0.5f) + 16);
+    }
+
+    float minutesStartX = (colCount * 32) - 97;
+    float secondsStartX = (colCount * 32) - 54;
+    float digitsY = 32 * (rowCount + .5f) + 16;
+
+    timerDigits[0].setPosition(minutesStartX, digitsY);
+    timerDigits[1].setPosition(minutesStartX + 21, digitsY);
+    timerDigits[2].setPosition(secondsStartX, digitsY);
+    timerDigits[3].setPosition(secondsStartX + 21, digitsY);
+
+    updateCounter();
+}
+
+// run one tile action through the board, then update only the tiles it changed
+// and check win/loss once for the whole action (a chord or flood can open many tiles)
+void GameScene::applyAction(int row, int col, ReplayAction action) {
+    if (gameOver || paused) {
+        return;
+    }
+
+    int cell = row * colCount + col;
+    uint32_t tick = currentTick();
+    if (!practiceMode) {
+        recorder.record(tick, cell, action);
+        journal.append(tick, cell, action);
+    }
+
+    if (action == ReplayAction::Reveal) {
+        board.reveal(cell);
+    } else if (action == ReplayAction::Flag) {
+        board.toggleFlag(cell);
+    } else if (action == ReplayAction::Chord) {
+        board.chord(cell);
+    }
+
+    if (practiceMode) {
+        history.record(board, action == ReplayAction::Flag ? Board::FLAGGED_BIT : Board::REVEALED_BIT);
+    }
+
+    for (int changedCell : board.getChanged()) {
+        syncTile(changedCell);
+    }
+
+    if (flagCount != board.getFlagCount()) {
+        flagCount = board.getFlagCount();
+        updateCounter();
+    }
+
+    if (board.isLost()) {
+        gameDefeat();
+    } else if (board.isWon()) {
+        checkVictory();
+    }
+}
+
+// copy a tile's revealed/flagged state from the board to its sprite tile
+void GameScene::syncTile(int cell) {
+    Tile& tile = tiles[cell / colCount][cell % colCount];
+    tile.setRevealed(board.isRevealed(cell));
+    tile.setFlag(board.isFlagged(cell));
+}
+
+void GameScene::syncAllTiles() {
+    int cellCount = rowCount * colCount;
+    for (int cell = 0; cell < cellCount; ++cell) {
+        syncTile(cell);
+    }
+    flagCount = board.getFlagCount();
+    updateCounter();
+}
+
+void GameScene::checkVictory() {
+    gameWon = true;
+    gameOver = true;
+
+    for (int row = 0; row < rowCount; ++row) { // auto flag all mines if game has been won
+        for (int col = 0; col < colCount; ++col) {
+            if (tiles[row][col].getMine() && !tiles[row][col].getFlagged()) {
+                tiles[row][col].setFlag(true);
+                flagCount++;
+            }
+        }
+    }
+    updateCounter();
+
+    faceButton.setTexture(resources.texture(TextureId::FaceWin));
+    timerRunning = false;
+    uint32_t tick = currentTick();
+    recorder.finish(tick, ReplayResult::Won);
+    if (!practiceMode) {
+        endJournal(); // a practice game has none, the save may be the parked ranked game
+        openLeaderboard(true); // practice wins could have been undone into, they don't count
+    }
+}
+
+void GameScene::gameDefeat() {
+    gameOver = true;
+
+    // if the game is over we can show all the tiles 
+    for (int row = 0; row < rowCount; ++row) {
+        for (int col = 0; col < colCount; ++col) {
+            if (tiles[row][col].getMine()) {
+                tiles[row][col].setRevealed(true);
+            }
+        }
+    }
+    faceButton.setTexture(resources.texture(TextureId::FaceLose));
+    timerRunning = false;
+    recorder.finish(currentTick(), ReplayResult::Lost);
+    if (!practiceMode) {
+        endJournal();
+        leaderboardService.recordLoss(playerName, {colCount, rowCount, mineCount});
+    }
+}
+
+void GameScene::resetGame(bool resumeRanked) {
+    // reset game settings
+    gameOver = false;
+    gameWon = false;
+    debugMode = false;
+    paused = false;
+    flagCount = 0;
+    elapsedSeconds = 0;
+    replayMode = false;
+    window.setTitle(practiceMode ? "Minesweeper - practice" : "Minesweeper");
+
+    faceButton.setTexture(resources.texture(TextureId::FaceHappy));
+
+    pauseButton.setTexture(resources.texture(TextureId::Pause));
+
+    if (recorder.isRecording()) {
+        recorder.finish(currentTick(), ReplayResult::Abandoned);
+    }
+    if (!resumeRanked || !resumeGame()) {
+        newGame();
+    }
+}
+
+void GameScene::updateCounter() {
+    int remainingMines = mineCount - flagCount;
+    drawDigits(remainingMines, counterDigits, true);
+}
+
+void GameScene::updateTimer() {
+    FrameProfiler::Scope phase(profiler, FramePhase::UpdateTimer);
+    if (replayMode) {
+        elapsedSeconds = static_cast<int>(replayTime / 1000);
+    } else if (!timerRunning) {
+        return;
+    } else {
+        auto currentTime = chrono::high_resolution_clock::now();
+        auto elapsedDuration = chrono::duration_cast<chrono::seconds>(currentTime - startTime);
+        elapsedSeconds = elapsedDuration.count();
+    }
+
+    if (elapsedSeconds > 999) {
+        elapsedSeconds = 999;
+    }
+
+    int minutes = elapsedSeconds / 60;
+    int seconds = elapsedSeconds % 60;
+
+    timerDigits[0].setTextureRect(sf::IntRect((minutes/10) * 21, 0, 21, 32));
+    timerDigits[1].setTextureRect(sf::IntRect((minutes % 10) * 21, 0, 21, 32));
+    timerDigits[2].setTextureRect(sf::IntRect((seconds / 10) * 21, 0, 21, 32));
+    timerDigits[3].setTextureRect(sf::IntRect((seconds % 10) * 21, 0, 21, 32));
+}
+
+void GameScene::drawDigits(int value, vector<sf::Sprite>& digitSprites, bool showMinus) {
+    bool isNegative = value < 0;
+
+    if (isNegative) {
+        value = -value;
+    }
+
+    for (int i = digitSprites.size() - 1; i >= 0; i--) {
+        int digit = value % 10;
+        digitSprites[i].setTextureRect(sf::IntRect(digit * 21, 0, 21, 32));
+        value /= 10;
+    }
+
+    if (isNegative && showMinus) {
+        profiler.draw(window, minusSign);
+    }
+}
+
+void GameScene::openLeaderboard(bool checkVictory) {
+    leaderboardStoppedTimer = timerRunning;
+    timerRunning = false;
+
+    if (!paused) {
+        pauseTime = chrono::high_resolution_clock::now();
+    }
+
+    leaderboardWasPaused = paused;
+    paused = true; // board is hidden under the overlay
+
+    int leaderboardWidth = (colCount * 16) + 50;
+    int leaderboardHeight = (rowCount * 16) + 50;
+
+    // queue the win first so it's being verified + saved while the leaderboard opens,
+    // the service re-simulates the replay itself instead of trusting our timer/stats
+    future<LeaderboardSubmission> submission;
+    if (checkVictory && gameWon) {
+        submission = leaderboardService.submit(playerName, recorder.lastGame(), LeaderboardScene::SHOWN_ENTRIES);
+    }
+
+    auto leaderboard = make_unique<LeaderboardScene>(stack, leaderboardWidth, leaderboardHeight, BoardConfig{colCount, rowCount, mineCount}, playerName, leaderboardService);
+    if (submission.valid()) {
+        leaderboard->showSubmission(move(submission));
+    }
+    stack.push(move(leaderboard));
+}
+
+void GameScene::onResume() {
+    paused = leaderboardWasPaused;
+
+    if (!paused && leaderboardStoppedTimer && !gameOver) {
+        startTime += chrono::high_resolution_clock::now() - pauseTime;
+        timerRunning = true;
+    }
+}
+
+// undo/redo only touches the tiles that action changed, unless it leaves a finished game
+// (defeat/victory redrew every mine) in which case the whole grid is resynced once
+void GameScene::stepHistory(bool forward) {
+    if (!practiceMode || replayMode || paused) {
+        return;
+    }
+
+    bool wasOver = gameOver;
+    if (!(forward ? history.redo(board) : history.undo(board))) {
+        return;
+    }
+
+    if (wasOver) {
+        gameOver = false;
+        gameWon = false;
+        faceButton.setTexture(resources.texture(TextureId::FaceHappy));
+        startTime = chrono::high_resolution_clock::now() - chrono::seconds(elapsedSeconds);
+        timerRunning = true;
+        syncAllTiles();
+    } else {
+        for (int changedCell : board.getChanged()) {
+            syncTile(changedCell);
+        }
+        if (flagCount != board.getFlagCount()) {
+            flagCount = board.getFlagCount();
+            updateCounter();
+        }
+    }
+
+    if (board.isLost()) {
+        gameDefeat();
+    } else if (board.isWon()) {
+        checkVictory();
+    }
+}
+
+void GameScene::playReplay(const Replay& replay) {
+    if (replay.header.colCount != colCount || replay.header.rowCount != rowCount) {
+        cerr << "Replay board size does not match this window" << endl;
+        return;
+    }
+
+    // build the board + tiles for the replay's seed, then the player keeps driving that board
+    mineCount = replay.header.mineCount;
+    replayPlayer.load(replay, board);
+    setupBoard();
+
+    replayMode = true;
+    replayPlaying = true;
+    replaySpeed = 1.0f;
+    replayTime = 0;
+    gameOver = false;
+    gameWon = false;
+    paused = false;
+    timerRunning = false;
+    lastFrameTime = chrono::high_resolution_clock::now();
+
+    pauseButton.setTexture(resources.texture(TextureId::Pause));
+    updateReplayFace();
+    updateReplayTitle();
+}
+
+// advance replay time by the frame time (x speed) and apply every move that is now due
+void GameScene::updateReplay() {
+    auto now = chrono::high_resolution_clock::now();
+    double frameMillis = chrono::duration<double, milli>(now - lastFrameTime).count();
+    lastFrameTime = now;
+
+    if (!replayPlaying) return;
+
+    // clamp so a long stall (window dragged, leaderboard open) doesnt jump ahead
+    replayTime += min(frameMillis, 100.0) * replaySpeed;
+    if (replayTime >= replayPlayer.getEndTick()) {
+        replayTime = replayPlayer.getEndTick();
+        replayPlaying = false;
+        pauseButton.setTexture(resources.texture(TextureId::Play));
+    }
+
+    bool anyMove = false;
+    while (!replayPlayer.atEnd() && replayPlayer.nextTick() <= replayTime) {
+        replayPlayer.step();
+        for (int changedCell : board.getChanged()) {
+            syncTile(changedCell);
+        }
+        anyMove = true;
+    }
+
+    if (anyMove) {
+        busyThisFrame = true;
+        flagCount = board.getFlagCount();
+        updateCounter();
+        updateReplayFace();
+    }
+}
+
+void GameScene::seekReplay(double timeMillis) {
+    replayTime = max(0.0, min(timeMillis, static_cast<double>(replayPlayer.getEndTick())));
+    replayPlayer.seekToTick(static_cast<uint32_t>(replayTime));
+    syncAllTiles();
+    updateReplayFace();
+}
+
+void GameScene::handleReplayKey(sf::Keyboard::Key key) {
+    if (key == sf::Keyboard::Space) {
+        if (!replayPlaying && replayTime >= replayPlayer.getEndTick()) {
+            seekReplay(0); // play again from the start
+        }
+        replayPlaying = !replayPlaying;
+        pauseButton.setTexture(replayPlaying ? resources.texture(TextureId::Pause) : resources.texture(TextureId::Play));
+    } else if (key == sf::Keyboard::Up || key == sf::Keyboard::Add || key == sf::Keyboard::Equal) {
+        replaySpeed = min(replaySpeed * 2, 16.0f);
+    } else if (key == sf::Keyboard::Down || key == sf::Keyboard::Subtract || key == sf::Keyboard::Hyphen) {
+        replaySpeed = max(replaySpeed / 2, 0.25f);
+    } else if (key == sf::Keyboard::Left) {
+        seekReplay(replayTime - 5000);
+    } else if (key == sf::Keyboard::Right) {
+        seekReplay(replayTime + 5000);
+    } else if (key == sf::Keyboard::Home) {
+        seekReplay(0);
+    } else if (key == sf::Keyboard::End) {
+        seekReplay(replayPlayer.getEndTick());
+    }
+    updateReplayTitle();
+}
+
+// face + shown mines follow the replayed board since it can go back and forth
+void GameScene::updateReplayFace() {
+    if (board.isLost()) {
+        faceButton.setTexture(resources.texture(TextureId::FaceLose));
+        for (int row = 0; row < rowCount; ++row) {
+            for (int col = 0; col < colCount; ++col) {
+                if (tiles[row][col].getMine()) {
+                    tiles[row][col].setRevealed(true);
+                }
+            }
+        }
+    } else if (board.isWon()) {
+        faceButton.setTexture(resources.texture(TextureId::FaceWin));
+    } else {
+        faceButton.setTexture(resources.texture(TextureId::FaceHappy));
+    }
+}
+
+void GameScene::updateReplayTitle() {
+    ostringstream title;
+    title << "Minesweeper - replay of " << replayPlayer.getReplay().header.playerName << " (" << replaySpeed << "x)";
+    window.setTitle(title.str());
+}
+
+void GameScene::drawBoard() {
+    FrameProfiler::Scope phase(profiler, FramePhase::DrawBoard);
+    if (paused) {
+        for (int row = 0; row < rowCount; ++row) {
+            for (int col = 0; col < colCount; ++col) {
+                tiles[row][col].drawRevealed(window, profiler);
+            }
+        }
+    } else {
+        for (int row = 0; row < rowCount; ++row) {
+            for (int col = 0; col < colCount; ++col) {
+                tiles[row][col].draw(window, profiler, debugMode);
+            }
+        }
+    }
+}
+
+void GameScene::drawUI() {
+    FrameProfiler::Scope phase(profiler, FramePhase::DrawUI);
+    profiler.draw(window, faceButton);
+
+    if (!gameOver) {
+        profiler.draw(window, debugButton);
+    }
+
+    if (!gameOver) {
+        profiler.draw(window, pauseButton);
+    }
+
+    profiler.draw(window, leaderboardButton);
+
+    for (const auto& digit : counterDigits) {
+        profiler.draw(window, digit);
+    }
+
+    for (const auto& digit: timerDigits) {
+        profiler.draw(window, digit);
+    }
+
+    profiler.draw(window, profilerButton);
+    profiler.draw(window, profilerLabel);
+}
+
+void GameScene::handleEvent(const sf::Event& event) {
+    if (event.type == sf::Event::KeyPressed) {
+        sf::Keyboard::Key key = event.key.code;
+        if (key == sf::Keyboard::F3) {
+            profiler.toggle(); // works while watching a replay too
+        } else if (replayMode) {
+            handleReplayKey(key);
+        } else if (key == sf::Keyboard::P) {
+            togglePractice();
+        } else if (event.key.control && (key == sf::Keyboard::Y || (key == sf::Keyboard::Z && event.key.shift))) {
+            stepHistory(true);
+        } else if (event.key.control && key == sf::Keyboard::Z) {
+            stepHistory(false);
+        } else if (gameOver && !practiceMode && key == sf::Keyboard::R) {
+            // watch the game that just ended
+            Replay replay;
+            const vector<uint8_t>& bytes = recorder.lastGame();
+            if (parseReplay(bytes.data(), bytes.size(), replay)) {
+                playReplay(replay);
+            }
+        }
+    }
+
+    if (event.type == sf::Event::MouseButtonPressed) {
+        sf::Vector2i mousePosition(event.mouseButton.x, event.mouseButton.y);
+
+        // if user clicks face button -> reset game (the viewer has no game, it watches again from the start)
+        if (faceButton.getGlobalBounds().contains(static_cast<float>(mousePosition.x), static_cast<float>(mousePosition.y))) {
+            if (viewerOnly) {
+                seekReplay(0);
+                if (!replayPlaying) {
+                    handleReplayKey(sf::Keyboard::Space);
+                }
+            } else {
+                resetGame();
+            }
+        }
+
+        if (profilerButton.getGlobalBounds().contains(static_cast<float>(mousePosition.x), static_cast<float>(mousePosition.y))) {
+            profiler.toggle();
+        }
+
+        // if user clicks debug button -> set it to opposite 
+        if (!gameOver && debugButton.getGlobalBounds().contains(static_cast<float>(mousePosition.x), static_cast<float>(mousePosition.y))) {
+            debugMode = !debugMode;
+        }
+
+        // in a replay the pause button is play/pause for the playback
+        if (replayMode && pauseButton.getGlobalBounds().contains(static_cast<float>(mousePosition.x), static_cast<float>(mousePosition.y))) {
+            handleReplayKey(sf::Keyboard::Space);
+        }
+
+        // if user clicks pause button -> set it to opposite and update sprite
+        if (!replayMode && !gameOver && pauseButton.getGlobalBounds().contains(static_cast<float>(mousePosition.x), static_cast<float>(mousePosition.y))) {
+            paused = !paused;
+            if (paused) {
+                pauseButton.setTexture(resources.texture(TextureId::Play));
+                pauseTime = chrono::high_resolution_clock::now();
+                timerRunning = false;
+            } else {
+                pauseButton.setTexture(resources.texture(TextureId::Pause));
+                if (!gameOver) {
+                    startTime += chrono::high_resolution_clock::now() - pauseTime;
+                    timerRunning = true;
+                }
+            }
+        }
+
+        if (leaderboardButton.getGlobalBounds().contains(static_cast<float>(mousePosition.x), static_cast<float>(mousePosition.y))) {
+            openLeaderboard(false);
+        }
+
+        // if user clicks a tile -> reveal, flag, or chord based on the button(s)
+        // tiles are a fixed 32px grid so we can index straight into it instead of hit testing every tile
+        if (!replayMode && !paused && !gameOver && mousePosition.x >= 0 && mousePosition.y >= 0) {
+            int row = mousePosition.y / 32;
+            int col = mousePosition.x / 32;
+
+            if (row < rowCount && col < colCount) {
+                sf::Mouse::Button button = event.mouseButton.button;
+                bool chord = button == sf::Mouse::Middle
+                    || (button == sf::Mouse::Left && sf::Mouse::isButtonPressed(sf::Mouse::Right))
+                    || (button == sf::Mouse::Right && sf::Mouse::isButtonPressed(sf::Mouse::Left));
+
+                if (chord) {
+                    applyAction(row, col, ReplayAction::Chord);
+                } else if (button == sf::Mouse::Left) {
+                    applyAction(row, col, ReplayAction::Reveal);
+                } else if (button == sf::Mouse::Right) {
+                    applyAction(row, col, ReplayAction::Flag);
+                }
+            }
+        }
+    }
+}
+
+void GameScene::update() {
+    busyThisFrame = false;
+    if (practiceAsked && chrono::high_resolution_clock::now() - practiceAskedTime > chrono::milliseconds(PRACTICE_CONFIRM_MILLIS)) {
+        practiceAsked = false; // not confirmed, back to the normal title
+        window.setTitle("Minesweeper");
+        busyThisFrame = true;
+    }
+    if (replayMode) {
+        updateReplay();
+    }
+    updateTimer();
+}
+
+// always the stack's window, same as `window`
+void GameScene::draw(sf::RenderWindow&) {
+    window.clear(sf::Color::White); // clear w white bg
+
+    drawBoard();
+    drawUI();
+}
+
+void GameScene::onExit() {
+    saveCurrentGame();
+}
@@ -0,0 +1,192 @@
+/*
+purpose: represents main game screen for game (a Scene in the shared window, see SceneStack.h)
+handles ga,e board, UI elements, and all game logic
+
+Implementations:
+- creates and manages grid of Tile objects representing game board
+- handles user interactions (mouse clicks, button pressed)
+- manages game state (running, paused, won, lost)
+- controls UI elements (buttons, timers)
+- the leaderboard button / a win pushes the leaderboard overlay (see LeaderboardScene.h),
+  the game pauses under it and picks up again when it's popped
+- drives the game logic in Board (see Board.h) and mirrors its state onto the tiles
+    - revealing tiles and adjacent empty tiles
+    - chording (middle click or left+right) on a satisfied number
+    - flag replacement and removal
+    - victory / defeat conditions 
+    - timer & pause/play functionality 
+- seeds each board so it can be regenerated exactly, and records every game as a replay
+- closing the window mid game saves it (see SaveGame.h), the next start on the same board resumes it
+  (saves/<player>_<cols>x<rows>_<mines>.msv, so every board size keeps its own)
+- every move is also written to a crash journal (see Journal.h), so after a crash
+  the next start rebuilds the game from the last save + journal
+- replay mode: plays a recorded game back with play/pause, speed and seeking
+    - space / pause button = play/pause, up/down = speed, left/right = seek 5s, home/end = start/end
+    - R after a game ends watches that game, face button goes back to a new game
+    - the replay viewer constructor ("--replay") only watches: it never resumes, journals or
+      saves the replay player's own game, and the face button restarts the replay
+- practice mode (P toggles, starts a new game): ctrl+Z undo, ctrl+Y / ctrl+shift+Z redo,
+  even after hitting a mine (see UndoHistory.h)
+    - P during a ranked game asks first (press P again within PRACTICE_CONFIRM_MILLIS), then
+      saves it and closes its journal, leaving practice resumes it
+    - practice games never write to the journal or the save
+- every finished non-practice game goes into the player's stats (see PlayerStatsStore.h): losses
+  right away, wins only once the leaderboard has verified their replay
+- the small "perf" button under the debug button (or F3, also while watching a replay) shows
+  the frame profiler overlay (see FrameProfiler.h), updateTimer / drawBoard / drawUI are its
+  game phases and every sprite / text / shape is drawn through it so it counts them
+*/
+
+#ifndef GAMESCENE_H
+#define GAMESCENE_H
+
+#include "Scene.h"
+#include "SceneStack.h"
+#include "Tile.h"
+#include "ResourceCache.h"
+#include "Board.h"
+#include "LeaderboardScene.h"
+#include "LeaderboardService.h"
+#include "Replay.h"
+#include "ReplayPlayer.h"
+#include "Journal.h"
+#include "UndoHistory.h"
+
+#include <SFML/Graphics.hpp>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <cstdint>
+using namespace std;
+
+class GameScene : public Scene {
+private:
+    // basic settings 
+    sf::RenderWindow& window; // the stack's, shared by every scene
+    int colCount;
+    int rowCount;
+    int mineCount;
+    string playerName;
+
+    // manage game state
+    bool gameOver;
+    bool gameWon;
+    bool debugMode;
+    bool paused;
+    int flagCount;
+
+    // timer implementation 
+    chrono::time_point<chrono::high_resolution_clock> startTime;
+    chrono::time_point<chrono::high_resolution_clock> pauseTime;
+    int elapsedSeconds;
+    bool timerRunning;
+
+    // board generation is seeded so replays can rebuild the exact same mines
+    uint64_t seed;
+    ReplayRecorder recorder;
+    Journal journal; // crash safety for the game in progress
+    bool ownsSave;   // the save file holds this game (resumed from it or written by it), only then is it removed
+
+    // practice mode: undo/redo allowed, so games aren't recorded, saved or ranked
+    static const int PRACTICE_CONFIRM_MILLIS = 3000;
+    bool practiceMode;
+    UndoHistory history;
+    bool practiceAsked; // P was pressed once mid ranked game, waiting for the second press
+    chrono::time_point<chrono::high_resolution_clock> practiceAskedTime;
+
+    // replay playback mode (watching a recorded game instead of playing)
+    bool viewerOnly; // opened just to watch a replay, there is no game of our own
+    bool replayMode;
+    bool replayPlaying;
+    float replaySpeed;
+    double replayTime; // ms into the replay
+    bool busyThisFrame; // a replay move or a title change this frame, both allocate
+    chrono::time_point<chrono::high_resolution_clock> lastFrameTime;
+    ReplayPlayer replayPlayer;
+
+    // leaderboard disk i/o + win verification, on its own thread
+    LeaderboardService leaderboardService;
+    // state to restore when the leaderboard overlay is popped
+    bool leaderboardWasPaused;
+    bool leaderboardStoppedTimer;
+
+    // resources
+    ResourceCache& resources; // textures, loaded once per process
+    const sf::Font& font;     // the stack's
+
+    // game board: rules live in the headless Board, tiles are just its sprites
+    Board board;
+    vector<vector<Tile>> tiles;
+
+    // UI elem
+    sf::Sprite faceButton;
+    sf::Sprite debugButton;
+    sf::Sprite pauseButton;
+    sf::Sprite leaderboardButton;
+    vector<sf::Sprite> counterDigits;
+    vector<sf::Sprite> timerDigits;
+    sf::Sprite minusSign;
+    sf::RectangleShape profilerButton; // frame profiler on / off
+    sf::Text profilerLabel;
+    FrameProfiler& profiler;           // the stack's
+
+    // window, textures and buttons, no game yet (both public constructors build on this)
+    GameScene(SceneStack& stack, int colCount, int rowCount, int mineCount, const string& playerName, bool viewerOnly);
+
+    // load resources & init game
+    void loadTextures();
+    void setupBoard();
+    void newGame();
+    uint32_t currentTick() const;
+    string savePath() const;
+    string journalPath() const;
+    void adoptOldSave();
+    bool writeSave(uint32_t elapsedMillis);
+    void endJournal();
+    bool saveCurrentGame(); // false only if there was a game to save and writing it failed
+    bool resumeGame();
+    void togglePractice();
+
+    // helper methods 
+    void applyAction(int row, int col, ReplayAction action);
+    void syncTile(int cell);
+    void syncAllTiles();
+    void checkVictory();
+    void gameDefeat();
+    void resetGame(bool resumeRanked = false); // resumeRanked: pick the saved ranked game back up if there is one
+    void updateCounter();
+    void updateTimer();
+    void openLeaderboard(bool checkVictory);
+    void stepHistory(bool forward); // practice undo (false) / redo (true)
+
+    // replay helpers
+    void playReplay(const Replay& replay); // switch to watching a replay (board must be the same size, no game in progress)
+    void updateReplay();
+    void seekReplay(double timeMillis);
+    void handleReplayKey(sf::Keyboard::Key key);
+    void updateReplayFace();
+    void updateReplayTitle();
+
+    void drawBoard();
+    void drawUI();
+    void drawDigits(int value, vector<sf::Sprite>& digitSprites, bool showMinus = false);
+
+public:
+    // journalLagMillis = how long a move may wait before it's fsynced to the crash journal
+    GameScene(SceneStack& stack, int colCount, int rowCount, int mineCount, const string& playerName, int journalLagMillis = 50);
+    // replay viewer, the board comes from the replay's header
+    GameScene(SceneStack& stack, const Replay& replay);
+
+    void handleEvent(const sf::Event& event) override;
+    void update() override;
+    void draw(sf::RenderWindow& window) override;
+    void onResume() override; // leaderboard closed
+    void onExit() override;   // window closing: save the unfinished game
+    bool isIdle() const override { return !busyThisFrame; } // the timer ticking doesn't allocate
+};
+
+
+
+
+
+#endif
\ No newline at end of file
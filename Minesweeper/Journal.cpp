@@ -0,0 +1,209 @@
+/*
+key components:
+- command queue: begin/append/discard just push a command under a short lock
+- writer thread: drains commands in batches, one write + one fsync per batch (group commit)
+- checksum: FNV-1a over each record so torn/garbage tail records are detected
+- read: loads the header and every valid record for crash recovery
+*/
+
+#include "Journal.h"
+#include "SessionTrace.h"
+#include <fstream>
+#include <iostream>
+#include <cstring>
+#include <cstddef>
+#include <chrono>
+#include <filesystem>
+#include <fcntl.h>
+#include <unistd.h>
+
+static const char JOURNAL_MAGIC[4] = {'M', 'S', 'J', 'L'};
+static const uint32_t JOURNAL_VERSION = 1;
+
+static uint32_t recordChecksum(const JournalRecord& record) {
+    uint32_t hash = 2166136261u;
+    const uint8_t* bytes = reinterpret_cast<const uint8_t*>(&record);
+    for (size_t i = 0; i < offsetof(JournalRecord, checksum); ++i) {
+        hash = (hash ^ bytes[i]) * 16777619u;
+    }
+    return hash;
+}
+
+static void appendBytes(vector<uint8_t>& out, const void* data, size_t size) {
+    const uint8_t* bytes = static_cast<const uint8_t*>(data);
+    out.insert(out.end(), bytes, bytes + size);
+}
+
+// write everything buffered so far (handles short writes)
+static void flushBytes(int fd, vector<uint8_t>& bytes) {
+    size_t written = 0;
+    while (fd >= 0 && written < bytes.size()) {
+        ssize_t n = ::write(fd, bytes.data() + written, bytes.size() - written);
+        if (n <= 0) {
+            cerr << "Failed to write journal" << endl;
+            break;
+        }
+        written += n;
+    }
+    bytes.clear();
+}
+
+Journal::Journal() : lagMillis(50), stopping(false) {
+    writer = thread(&Journal::writerLoop, this);
+}
+
+Journal::~Journal() {
+    {
+        lock_guard<mutex> lock(queueMutex);
+        stopping = true;
+    }
+    queueReady.notify_one();
+    writer.join();
+}
+
+void Journal::setLag(int lagMillis) {
+    lock_guard<mutex> lock(queueMutex);
+    this->lagMillis = lagMillis < 0 ? 0 : lagMillis;
+}
+
+void Journal::push(Command command) {
+    {
+        lock_guard<mutex> lock(queueMutex);
+        queue.push_back(move(command));
+    }
+    queueReady.notify_one();
+}
+
+void Journal::begin(const string& path, const JournalHeader& header) {
+    currentPath = path;
+    Command command = {};
+    command.type = Command::Open;
+    command.path = path;
+    command.header = header;
+    push(move(command));
+}
+
+void Journal::append(uint32_t tick, uint32_t cell, ReplayAction action) {
+    if (currentPath.empty()) return;
+
+    Command command = {};
+    command.type = Command::Append;
+    command.record.tick = tick;
+    command.record.cell = cell;
+    command.record.action = static_cast<uint32_t>(action);
+    command.record.checksum = recordChecksum(command.record);
+    push(move(command));
+}
+
+void Journal::discard() {
+    if (currentPath.empty()) return;
+
+    Command command = {};
+    command.type = Command::Close;
+    command.path = currentPath;
+    currentPath.clear();
+    push(move(command));
+}
+
+void Journal::removeFile(const string& path) {
+    Command command = {};
+    command.type = Command::Remove;
+    command.path = path;
+    push(move(command));
+}
+
+void Journal::writerLoop() {
+    SessionTrace::nameThread("journal");
+    int fd = -1;
+    vector<uint8_t> pending;
+
+    while (true) {
+        deque<Command> batch;
+        {
+            unique_lock<mutex> lock(queueMutex);
+            queueReady.wait(lock, [this] { return stopping || !queue.empty(); });
+            if (queue.empty()) {
+                break; // stopping and nothing left
+            }
+
+            // group commit: give more moves a chance to arrive so they share one fsync
+            if (!stopping && lagMillis > 0) {
+                queueReady.wait_for(lock, chrono::milliseconds(lagMillis), [this] { return stopping; });
+            }
+            batch.swap(queue);
+        }
+        SessionTrace::Scope trace("journal write", "journal io");
+        trace.setArg("commands", static_cast<int64_t>(batch.size()));
+
+        for (Command& command : batch) {
+            switch (command.type) {
+                case Command::Open: {
+                    flushBytes(fd, pending);
+                    if (fd >= 0) ::close(fd);
+
+                    error_code ec;
+                    filesystem::create_directories(filesystem::path(command.path).parent_path(), ec);
+                    fd = ::open(command.path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+                    if (fd < 0) {
+                        cerr << "Failed to open journal: " << command.path << endl;
+                    }
+                    appendBytes(pending, &command.header, sizeof(command.header));
+                    break;
+                }
+                case Command::Append:
+                    appendBytes(pending, &command.record, sizeof(command.record));
+                    break;
+                case Command::Close:
+                    pending.clear();
+                    if (fd >= 0) ::close(fd);
+                    fd = -1;
+                    ::unlink(command.path.c_str());
+                    break;
+                case Command::Remove:
+                    ::unlink(command.path.c_str());
+                    break;
+            }
+        }
+
+        if (!pending.empty()) {
+            flushBytes(fd, pending);
+            if (fd >= 0) fsync(fd);
+        }
+    }
+
+    if (fd >= 0) ::close(fd);
+}
+
+JournalHeader Journal::makeHeader(bool fromSave, uint32_t baseMoveCount, uint64_t seed, int colCount, int rowCount, int mineCount) {
+    JournalHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, JOURNAL_MAGIC, sizeof(JOURNAL_MAGIC));
+    header.version = JOURNAL_VERSION;
+    header.fromSave = fromSave ? 1 : 0;
+    header.baseMoveCount = baseMoveCount;
+    header.seed = seed;
+    header.colCount = colCount;
+    header.rowCount = rowCount;
+    header.mineCount = mineCount;
+    return header;
+}
+
+bool Journal::read(const string& path, JournalHeader& header, vector<ReplayMove>& moves) {
+    ifstream file(path, ios::binary);
+    if (!file.is_open() || !file.read(reinterpret_cast<char*>(&header), sizeof(header))) {
+        return false;
+    }
+    if (memcmp(header.magic, JOURNAL_MAGIC, sizeof(JOURNAL_MAGIC)) != 0 || header.version != JOURNAL_VERSION) {
+        return false;
+    }
+
+    moves.clear();
+    JournalRecord record;
+    while (file.read(reinterpret_cast<char*>(&record), sizeof(record))) {
+        if (record.checksum != recordChecksum(record) || record.action > static_cast<uint32_t>(ReplayAction::Chord)) {
+            break; // torn write from the crash, everything before it is good
+        }
+        moves.push_back({record.tick, record.cell, static_cast<ReplayAction>(record.action)});
+    }
+    return true;
+}
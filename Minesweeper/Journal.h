@@ -0,0 +1,89 @@
+/*
+purpose: crash-safe write-ahead journal of the game in progress
+
+implementation:
+- every move is appended to saves/<player>_<cols>x<rows>_<mines>.journal as it happens
+- the journal starts with a header saying what it builds on: either a fresh board
+  (seed + size) or the player's save file (see SaveGame.h) after a given number of moves
+- after a crash, base + journal tail rebuilds the exact game
+- the game thread never touches the disk: it only queues commands, a background
+  thread does the writes
+- group commit: once a move arrives the writer waits up to lagMillis for more,
+  then writes the whole batch with one write + one fsync, so durability lag is
+  bounded by lagMillis (0 = fsync as soon as possible)
+- records are fixed size with a checksum so a torn last record is just ignored on recovery
+*/
+
+#ifndef JOURNAL_H
+#define JOURNAL_H
+
+#include "Replay.h"
+#include <string>
+#include <vector>
+#include <deque>
+#include <cstdint>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+using namespace std;
+
+struct JournalHeader {
+    char magic[4];            // "MSJL"
+    uint32_t version;
+    uint32_t fromSave;        // 0 = fresh board from seed, 1 = continues the save file
+    uint32_t baseMoveCount;   // moves already in the save (when fromSave)
+    uint64_t seed;
+    int32_t colCount;
+    int32_t rowCount;
+    int32_t mineCount;
+    uint32_t reserved;
+};
+
+struct JournalRecord {
+    uint32_t tick;
+    uint32_t cell;
+    uint32_t action;
+    uint32_t checksum;
+};
+
+class Journal {
+private:
+    struct Command {
+        enum Type { Open, Append, Close, Remove } type;
+        string path;
+        JournalHeader header;
+        JournalRecord record;
+    };
+
+    int lagMillis;
+    string currentPath;
+
+    thread writer;
+    mutex queueMutex;
+    condition_variable queueReady;
+    deque<Command> queue;
+    bool stopping;
+
+    void push(Command command);
+    void writerLoop();
+
+public:
+    Journal();
+    ~Journal();
+
+    void setLag(int lagMillis);
+
+    // start a new journal (replaces any old one at that path)
+    void begin(const string& path, const JournalHeader& header);
+    void append(uint32_t tick, uint32_t cell, ReplayAction action);
+    // game finished, the journal isn't needed anymore
+    void discard();
+    // delete some other file from the writer thread (e.g. a save that's been used up)
+    void removeFile(const string& path);
+
+    // recovery side (called at startup before anything is journaled)
+    static JournalHeader makeHeader(bool fromSave, uint32_t baseMoveCount, uint64_t seed, int colCount, int rowCount, int mineCount);
+    static bool read(const string& path, JournalHeader& header, vector<ReplayMove>& moves);
+};
+
+#endif
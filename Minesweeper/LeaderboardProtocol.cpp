@@ -0,0 +1,202 @@
+/*
+key components:
+- FrameWriter / FrameReader: flat binary encoding of strings and records (length prefixed)
+- sendFrame / receiveFrame: loop over write/read until the whole frame is through
+- noSigPipe / sendNoSignal: MSG_NOSIGNAL where it exists, SO_NOSIGPIPE on Apple
+- takeFrame: frame splitting for the daemon's per-client receive buffers
+- connectToDaemon: AF_UNIX stream socket to the daemon's socket file, with send / receive timeouts
+*/
+
+#include "LeaderboardProtocol.h"
+#include <cstring>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+void FrameWriter::putString(const string& text) {
+    put(static_cast<uint16_t>(text.size()));
+    bytes.insert(bytes.end(), text.begin(), text.end());
+}
+
+void FrameWriter::putRecord(const LeaderboardRecord& record) {
+    put(record.timeMillis);
+    put(static_cast<int32_t>(record.bbbv));
+    put(record.bbbvPerSecond);
+    put(record.efficiency);
+    put(record.order);
+    putString(record.name);
+}
+
+void FrameWriter::putRecords(const vector<LeaderboardRecord>& records) {
+    put(static_cast<uint32_t>(records.size()));
+    for (const LeaderboardRecord& record : records) {
+        putRecord(record);
+    }
+}
+
+void FrameWriter::putPage(const LeaderboardPage& page) {
+    put(static_cast<uint64_t>(page.offset));
+    put(static_cast<uint64_t>(page.total));
+    putRecords(page.records);
+}
+
+void FrameWriter::putSubmission(const LeaderboardSubmission& submission) {
+    put(static_cast<uint8_t>(submission.accepted));
+    put(static_cast<uint8_t>(submission.madeTopK));
+    put(static_cast<int32_t>(submission.config.colCount));
+    put(static_cast<int32_t>(submission.config.rowCount));
+    put(static_cast<int32_t>(submission.config.mineCount));
+    putRecord(submission.record);
+    put(submission.rank);
+    putString(submission.reason);
+    putRecords(submission.top);
+}
+
+bool FrameReader::getString(string& text) {
+    uint16_t size;
+    if (!get(size) || static_cast<size_t>(end - pos) < size) return false;
+    text.assign(reinterpret_cast<const char*>(pos), size);
+    pos += size;
+    return true;
+}
+
+bool FrameReader::getRecord(LeaderboardRecord& record) {
+    int32_t bbbv;
+    if (!get(record.timeMillis) || !get(bbbv) || !get(record.bbbvPerSecond) || !get(record.efficiency)
+        || !get(record.order) || !getString(record.name)) {
+        return false;
+    }
+    record.bbbv = bbbv;
+    return true;
+}
+
+bool FrameReader::getRecords(vector<LeaderboardRecord>& records) {
+    uint32_t count;
+    if (!get(count)) return false;
+    records.clear();
+    for (uint32_t i = 0; i < count; ++i) {
+        LeaderboardRecord record;
+        if (!getRecord(record)) return false;
+        records.push_back(move(record));
+    }
+    return true;
+}
+
+bool FrameReader::getPage(LeaderboardPage& page) {
+    uint64_t offset, total;
+    if (!get(offset) || !get(total) || !getRecords(page.records)) {
+        return false;
+    }
+    page.offset = offset;
+    page.total = total;
+    return true;
+}
+
+bool FrameReader::getSubmission(LeaderboardSubmission& submission) {
+    uint8_t accepted, madeTopK;
+    int32_t colCount, rowCount, mineCount;
+    if (!get(accepted) || !get(madeTopK) || !get(colCount) || !get(rowCount) || !get(mineCount)
+        || !getRecord(submission.record) || !get(submission.rank) || !getString(submission.reason) || !getRecords(submission.top)) {
+        return false;
+    }
+    submission.accepted = accepted != 0;
+    submission.madeTopK = madeTopK != 0;
+    submission.config = {colCount, rowCount, mineCount};
+    return true;
+}
+
+void noSigPipe(int fd) {
+#ifdef SO_NOSIGPIPE
+    int on = 1;
+    setsockopt(fd, SOL_SOCKET, SO_NOSIGPIPE, &on, sizeof(on));
+#else
+    (void)fd; // MSG_NOSIGNAL on every send does it
+#endif
+}
+
+ssize_t sendNoSignal(int fd, const uint8_t* data, size_t size) {
+#ifdef MSG_NOSIGNAL
+    return ::send(fd, data, size, MSG_NOSIGNAL);
+#else
+    return ::send(fd, data, size, 0);
+#endif
+}
+
+static bool writeAll(int fd, const uint8_t* data, size_t size) {
+    while (size > 0) {
+        ssize_t n = sendNoSignal(fd, data, size);
+        if (n <= 0) return false;
+        data += n;
+        size -= n;
+    }
+    return true;
+}
+
+static bool readAll(int fd, uint8_t* data, size_t size) {
+    while (size > 0) {
+        ssize_t n = ::read(fd, data, size);
+        if (n <= 0) return false;
+        data += n;
+        size -= n;
+    }
+    return true;
+}
+
+bool sendFrame(int fd, const vector<uint8_t>& payload) {
+    // header + payload in one buffer so small requests are one syscall
+    vector<uint8_t> frame(sizeof(uint32_t) + payload.size());
+    uint32_t size = payload.size();
+    memcpy(frame.data(), &size, sizeof(size));
+    memcpy(frame.data() + sizeof(size), payload.data(), payload.size());
+    return writeAll(fd, frame.data(), frame.size());
+}
+
+bool receiveFrame(int fd, vector<uint8_t>& payload) {
+    uint32_t size;
+    if (!readAll(fd, reinterpret_cast<uint8_t*>(&size), sizeof(size)) || size > MAX_FRAME_SIZE) {
+        return false;
+    }
+    payload.resize(size);
+    return readAll(fd, payload.data(), size);
+}
+
+int takeFrame(const vector<uint8_t>& buffer, size_t& offset, const uint8_t*& payload, uint32_t& payloadSize) {
+    uint32_t size;
+    size_t available = buffer.size() - offset;
+    if (available < sizeof(size)) return 0;
+    memcpy(&size, buffer.data() + offset, sizeof(size));
+    if (size > MAX_FRAME_SIZE) return -1;
+    if (available < sizeof(size) + size) return 0;
+
+    payload = buffer.data() + offset + sizeof(size);
+    payloadSize = size;
+    offset += sizeof(size) + size;
+    return 1;
+}
+
+int connectToDaemon(const string& socketPath) {
+    sockaddr_un address;
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    if (socketPath.size() >= sizeof(address.sun_path)) {
+        return -1;
+    }
+    memcpy(address.sun_path, socketPath.c_str(), socketPath.size());
+
+    int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) {
+        return -1;
+    }
+    // the client side blocks, so without these a stuck daemon would hang the leaderboard worker
+    // (and closing the game, which joins it); set before connect, a full backlog waits on the send timeout
+    timeval timeout = {DAEMON_TIMEOUT_MILLIS / 1000, (DAEMON_TIMEOUT_MILLIS % 1000) * 1000};
+    if (setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout)) != 0
+        || setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout)) != 0
+        || ::connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0) {
+        ::close(fd);
+        return -1;
+    }
+    noSigPipe(fd); // the daemon going away mid request mustn't kill the game
+    return fd;
+}
@@ -0,0 +1,110 @@
+/*
+purpose: wire format between games and the leaderboard daemon (Unix domain socket)
+
+implementation:
+- every message is a frame: 4 byte length, then the payload
+- requests start with a type byte:
+    'T' top:    cols, rows, mines, count
+    'S' submit: count, player name, then the raw replay bytes
+    'P' page:   cols, rows, mines, offset, count (at most MAX_PAGE_ROWS)
+- the top response is a record list, the page response a LeaderboardPage,
+  the submit response is a LeaderboardSubmission
+  (the daemon verifies the replay itself, clients are never trusted)
+- numbers are written in host byte order, both ends are always on the same machine
+- blocking helpers for the client side, the daemon does its own non-blocking buffering
+  and uses takeFrame to cut complete frames out of what it has received: it moves a read
+  offset instead of erasing, so the buffer is compacted once per read, not once per frame
+- frames are capped at MAX_FRAME_SIZE, the biggest valid submit (a replay at its size limit
+  plus the request fields), so a client can't make the daemon buffer more than that
+- a client socket gives up on any send / receive after DAEMON_TIMEOUT_MILLIS, so a daemon
+  that is running but stuck can't hang the game (the caller falls back to the local store)
+*/
+
+#ifndef LEADERBOARDPROTOCOL_H
+#define LEADERBOARDPROTOCOL_H
+
+#include "LeaderboardStore.h"
+#include "Replay.h"
+#include <string>
+#include <vector>
+#include <cstring>
+#include <cstdint>
+#include <sys/types.h>
+using namespace std;
+
+static const char* const LEADERBOARD_SOCKET = "leaderboard.sock";
+static const uint32_t MAX_FRAME_SIZE = MAX_REPLAY_BYTES + 4096; // + type, count and player name
+static const uint32_t MAX_PAGE_ROWS = 1000;
+static const int DAEMON_TIMEOUT_MILLIS = 2000; // a verify is a few ms, this is a daemon that's stuck
+
+// what a submitted win turned into (local or from the daemon)
+struct LeaderboardSubmission {
+    bool accepted;                    // replay verified and belongs to the player
+    string reason;                    // why not, when !accepted
+    bool madeTopK;                    // kept by the store
+    BoardConfig config;               // the verified board
+    LeaderboardRecord record;         // the verified result (its order highlights it, stats use its time)
+    uint64_t rank;                    // its 0 based place in the table (to scroll to it)
+    vector<LeaderboardRecord> top;    // the config's table after the insert
+};
+
+// appends values to a payload
+class FrameWriter {
+public:
+    vector<uint8_t> bytes;
+
+    template <typename T>
+    void put(const T& value) {
+        const uint8_t* raw = reinterpret_cast<const uint8_t*>(&value);
+        bytes.insert(bytes.end(), raw, raw + sizeof(T));
+    }
+    void putString(const string& text);
+    void putRecord(const LeaderboardRecord& record);
+    void putRecords(const vector<LeaderboardRecord>& records);
+    void putPage(const LeaderboardPage& page);
+    void putSubmission(const LeaderboardSubmission& submission);
+};
+
+// reads values back out of a payload, every get fails (returns false) once it runs out
+class FrameReader {
+private:
+    const uint8_t* pos;
+    const uint8_t* end;
+
+public:
+    FrameReader(const uint8_t* data, size_t size) : pos(data), end(data + size) {}
+
+    template <typename T>
+    bool get(T& value) {
+        if (static_cast<size_t>(end - pos) < sizeof(T)) return false;
+        memcpy(&value, pos, sizeof(T));
+        pos += sizeof(T);
+        return true;
+    }
+    bool getString(string& text);
+    bool getRecord(LeaderboardRecord& record);
+    bool getRecords(vector<LeaderboardRecord>& records);
+    bool getPage(LeaderboardPage& page);
+    bool getSubmission(LeaderboardSubmission& submission);
+    const uint8_t* remaining() const { return pos; }
+    size_t remainingSize() const { return end - pos; }
+};
+
+// blocking frame i/o on a connected socket (client side)
+bool sendFrame(int fd, const vector<uint8_t>& payload);
+bool receiveFrame(int fd, vector<uint8_t>& payload);
+
+// if `buffer` holds a whole frame at `offset`, point `payload` at it (inside the buffer) and move
+// `offset` past it (-1 = malformed, 0 = need more bytes, 1 = got one)
+int takeFrame(const vector<uint8_t>& buffer, size_t& offset, const uint8_t*& payload, uint32_t& payloadSize);
+
+// a write to a socket whose other end closed must fail, not raise SIGPIPE (which kills the process):
+// sendNoSignal passes MSG_NOSIGNAL where send() has it, on Apple there's no such flag and
+// noSigPipe sets SO_NOSIGPIPE on the socket instead (call it on every socket that's written to)
+void noSigPipe(int fd);
+ssize_t sendNoSignal(int fd, const uint8_t* data, size_t size);
+
+// connect to the daemon, -1 if it isn't running (the socket has the DAEMON_TIMEOUT_MILLIS timeouts)
+int connectToDaemon(const string& socketPath = LEADERBOARD_SOCKET);
+
+#endif
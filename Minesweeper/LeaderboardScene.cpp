@@ -0,0 +1,147 @@
+/*
+key components:
+- constructor: lays out the panel (centred in the stack's window) and asks the service for the existing scores
+- text management: cemnters and formats textr for display
+- storage: LeaderboardService / LeaderboardStore do the file i/o and ranking off this thread,
+  this window shows the table of the config it was opened for
+- view: LeaderboardView pages in and draws just the visible rows (see LeaderboardView.h)
+- results: polled once a frame, a checked win switches the view to its config and rank
+- stats line: the player's summary, formatted once when it arrives
+- event handling: escape / click outside the panel pops the scene, everything else goes to the view for scrolling
+- drawing: dims the game under it, then the panel, texts and view
+*/
+
+#include "LeaderboardScene.h"
+#include <iostream>
+#include <algorithm>
+#include <cstdio>
+using namespace std;
+
+// helper to set text in center 
+void LeaderboardScene::setText(sf::Text& text, float x, float y) {
+    sf::FloatRect textRect = text.getLocalBounds();
+    text.setOrigin(textRect.left + textRect.width/2.0f, textRect.top + textRect.height/2.0f);
+    text.setPosition(sf::Vector2f(x, y));
+}
+
+// constructor
+LeaderboardScene::LeaderboardScene(SceneStack& stack, int width, int height, const BoardConfig& config, const string& playerName, LeaderboardService& service)
+    : Scene(stack), font(stack.getFont()),
+      panel((static_cast<float>(stack.getWindow().getSize().x) - width) / 2.0f, (static_cast<float>(stack.getWindow().getSize().y) - height) / 2.0f, width, height),
+      config(config), service(service),
+      view(font, 14, sf::FloatRect(panel.left + 10, panel.top + height / 2.0f - 80, width - 20, height / 2.0f + 50), service),
+      playerName(playerName) {
+
+    // the game shows through, dimmed
+    shade.setSize(sf::Vector2f(stack.getWindow().getSize().x, stack.getWindow().getSize().y));
+    shade.setFillColor(sf::Color(0, 0, 0, 150));
+    background.setPosition(panel.left, panel.top);
+    background.setSize(sf::Vector2f(width, height));
+    background.setFillColor(sf::Color(0, 0, 255)); // blue
+    background.setOutlineColor(sf::Color::White);
+    background.setOutlineThickness(2);
+    
+    // set basic text 
+    titleText.setFont(font);
+    titleText.setString("LEADERBOARD");
+    titleText.setCharacterSize(20);
+    titleText.setFillColor(sf::Color::White);
+    titleText.setStyle(sf::Text::Bold | sf::Text::Underlined);
+    setText(titleText, panel.left + width / 2.0f, panel.top + height / 2.0f - 120);
+
+    // which board this table is for
+    configText.setFont(font);
+    configText.setCharacterSize(14);
+    configText.setFillColor(sf::Color::White);
+    updateConfigText();
+    
+    // the player's own numbers along the bottom
+    statsText.setFont(font);
+    statsText.setCharacterSize(12);
+    statsText.setFillColor(sf::Color::White);
+    statsText.setPosition(panel.left + 10, panel.top + height - 22);
+
+    // the actual data comes from the worker, the view shows "loading..." until it's there
+    view.show(config);
+    pendingSummary = service.playerSummary(playerName, config);
+}
+
+// m:ss.s, the stats line is short on room
+static string formatTime(uint32_t millis) {
+    char text[32];
+    snprintf(text, sizeof(text), "%u:%02u.%u", millis / 60000, millis / 1000 % 60, millis / 100 % 10);
+    return text;
+}
+
+void LeaderboardScene::updateStatsText(const PlayerSummary& summary) {
+    string text = playerName + ": ";
+    if (summary.games == 0) {
+        text += "no games yet";
+    } else {
+        text += to_string(summary.games) + " games, " + to_string(summary.wins * 100 / summary.games) + "% won";
+        if (summary.wins > 0) {
+            char rest[96];
+            snprintf(rest, sizeof(rest), ", median %s, p90 %s, %.2f 3BV/s, faster than %d%%",
+                     formatTime(summary.medianMillis).c_str(), formatTime(summary.p90Millis).c_str(),
+                     summary.medianBbbvPerSecond, static_cast<int>(summary.fasterThan * 100 + 0.5));
+            text += rest;
+        }
+    }
+    statsText.setString(text);
+}
+
+void LeaderboardScene::updateConfigText() {
+    configText.setString(to_string(config.colCount) + " x " + to_string(config.rowCount) + ", " + to_string(config.mineCount) + " mines");
+    setText(configText, panel.left + panel.width / 2.0f, panel.top + panel.height / 2.0f - 95);
+}
+
+void LeaderboardScene::showSubmission(future<LeaderboardSubmission> submission) {
+    pendingSubmission = move(submission);
+    view.setStatus("checking your game...");
+}
+
+// never blocks: only takes results that are already there
+void LeaderboardScene::update() {
+    if (pendingSubmission.valid() && pendingSubmission.wait_for(chrono::seconds(0)) == future_status::ready) {
+        LeaderboardSubmission submission = pendingSubmission.get();
+        if (submission.accepted) {
+            config = submission.config;
+            updateConfigText();
+            pendingSummary = service.playerSummary(playerName, config);
+            if (submission.madeTopK) {
+                view.showRecord(config, submission.record.order, submission.rank);
+            } else {
+                view.show(config);
+            }
+        } else {
+            // rejected win -> just show the table as it is
+            view.show(config);
+        }
+    }
+
+    if (pendingSummary.valid() && pendingSummary.wait_for(chrono::seconds(0)) == future_status::ready) {
+        updateStatsText(pendingSummary.get());
+    }
+
+    view.update();
+}
+
+void LeaderboardScene::handleEvent(const sf::Event& event) {
+    bool clickedOutside = event.type == sf::Event::MouseButtonPressed
+        && !panel.contains(static_cast<float>(event.mouseButton.x), static_cast<float>(event.mouseButton.y));
+    if ((event.type == sf::Event::KeyPressed && event.key.code == sf::Keyboard::Escape) || clickedOutside) {
+        stack.pop(); // game resumes in its onResume
+        return;
+    }
+    view.handleEvent(event);
+}
+
+void LeaderboardScene::draw(sf::RenderWindow& window) {
+    FrameProfiler& profiler = stack.getProfiler();
+    profiler.draw(window, shade);
+    profiler.draw(window, background);
+    profiler.draw(window, titleText);
+    profiler.draw(window, configText);
+    view.draw(window, profiler);
+    profiler.draw(window, statsText);
+}
@@ -0,0 +1,77 @@
+/*
+purpose: implements leaderboard overlay for game
+
+implementation overview:
+- pushed on the SceneStack over the game: a panel in the middle of the same window, the
+  paused game stays visible (dimmed) around it, so opening it creates no window
+- escape or a click outside the panel closes it and the game picks up where it was
+- player records live in a LeaderboardStore (see LeaderboardStore.h): per board
+  config, millisecond times, top-K heap, append-only leaderboard.txt + index
+- all reading / writing happens on the LeaderboardService worker thread, the panel
+  shows straight away showing "loading..." and fills in the table when its future is ready
+- each board config (cols x rows, mines) has its own table, the panel shows just
+  the one for the game's current config and shows it under the title
+- updates the leaderboard when a player achieves a new high score
+- the table itself is a LeaderboardView: scrolls through the whole table (mouse wheel,
+  arrows, page up / down, home / end), only the rows on screen are fetched and drawn
+- highlights new records with an asterick (*) and scrolls to them
+- the bottom line is the player's own stats on this config: games, win rate, median and
+  p90 win time, and how their median compares to everyone's wins (PlayerStatsStore)
+- stores each result's 3BV, 3BV/s and click efficiency alongside the time
+- only admits a win after re-simulating its replay (see ReplayVerifier.h),
+  the time and stats saved come from that re-simulation (done by the service)
+*/
+
+#ifndef LEADERBOARDSCENE_H
+#define LEADERBOARDSCENE_H
+
+#include "Scene.h"
+#include "SceneStack.h"
+#include "LeaderboardStore.h"
+#include "LeaderboardService.h"
+#include "LeaderboardView.h"
+#include <SFML/Graphics.hpp>
+#include <string>
+#include <vector>
+#include <future>
+#include <cstdint>
+using namespace std;
+
+class LeaderboardScene : public Scene {
+    const sf::Font& font; // the stack's, so opening the leaderboard doesn't load it again
+    sf::FloatRect panel;  // where in the window the leaderboard is drawn
+    sf::RectangleShape shade;
+    sf::RectangleShape background;
+    sf::Text titleText;
+    sf::Text configText;
+    sf::Text statsText;
+
+    BoardConfig config;
+    LeaderboardService& service;
+    LeaderboardView view;
+    string playerName;
+
+    future<LeaderboardSubmission> pendingSubmission; // a win still being checked
+    future<PlayerSummary> pendingSummary;
+
+    void setText(sf::Text& text, float x, float y);
+    void updateConfigText();
+    void updateStatsText(const PlayerSummary& summary);
+public:
+    // rows sent back with a submission (the view pages in the rest itself)
+    static const size_t SHOWN_ENTRIES = 5;
+
+    // width x height panel centred in the stack's window
+    LeaderboardScene(SceneStack& stack, int width, int height, const BoardConfig& config, const string& playerName, LeaderboardService& service);
+
+    void handleEvent(const sf::Event& event) override;
+    void update() override;
+    void draw(sf::RenderWindow& window) override;
+    bool isOverlay() const override { return true; }
+
+    // show the outcome of a submitted win instead of the plain table
+    void showSubmission(future<LeaderboardSubmission> submission);
+};
+
+#endif
+
@@ -0,0 +1,252 @@
+/*
+key components:
+- job queue: each request is a closure that fulfils its own promise, run by the worker in order
+- daemon: requests are tried over the daemon's socket first (reconnecting once if it dropped,
+  a timeout skips the daemon for a while instead)
+- top: otherwise open the config (index + bounded read) and copy out its best entries
+- page: same as top for any slice of the table (the leaderboard view asks for it in blocks)
+- stats: verified wins (submit) and losses (recordLoss) are flushed to player_stats.dat in batches,
+  the rest on shutdown; playerSummary reads the in-memory copy
+- submit: otherwise parse + verify the replay, insert the verified record, read back the table
+*/
+
+#include "LeaderboardService.h"
+#include "ReplayVerifier.h"
+#include "SessionTrace.h"
+#include <iostream>
+#include <memory>
+#include <algorithm>
+#include <cerrno>
+#include <unistd.h>
+
+LeaderboardService::LeaderboardService(const string& path, const string& socketPath, size_t capacity, const string& statsPath)
+    : store(path, capacity), stats(statsPath), socketPath(socketPath), daemonFd(-1), daemonRetryTime(), stopping(false) {
+    worker = thread(&LeaderboardService::workerLoop, this);
+}
+
+LeaderboardService::~LeaderboardService() {
+    {
+        lock_guard<mutex> lock(queueMutex);
+        stopping = true;
+    }
+    queueReady.notify_one();
+    worker.join(); // finishes whatever was queued (a submitted win is never dropped)
+    stats.flush();
+    if (daemonFd >= 0) {
+        ::close(daemonFd);
+    }
+}
+
+// one request/response round trip, false = no daemon (caller does it locally)
+bool LeaderboardService::askDaemon(const FrameWriter& request, vector<uint8_t>& response) {
+    SessionTrace::Scope trace("ask daemon", "leaderboard");
+    if (chrono::steady_clock::now() < daemonRetryTime) {
+        return false;
+    }
+    for (int attempt = 0; attempt < 2; ++attempt) {
+        if (daemonFd < 0) {
+            daemonFd = connectToDaemon(socketPath);
+            if (daemonFd < 0) {
+                return false;
+            }
+        }
+        errno = 0;
+        if (sendFrame(daemonFd, request.bytes) && receiveFrame(daemonFd, response)) {
+            return true;
+        }
+        bool timedOut = errno == EAGAIN || errno == EWOULDBLOCK;
+        // a late reply would be read as the next request's, so the connection goes either way
+        ::close(daemonFd);
+        daemonFd = -1;
+        if (timedOut) {
+            // it's there but stuck, asking again would just wait another timeout
+            cerr << "Leaderboard daemon isn't answering, using the leaderboard file for now" << endl;
+            daemonRetryTime = chrono::steady_clock::now() + chrono::milliseconds(DAEMON_BACKOFF_MILLIS);
+            return false;
+        }
+        // daemon restarted or went away, try a fresh connection once
+    }
+    return false;
+}
+
+void LeaderboardService::push(function<void()> job) {
+    {
+        lock_guard<mutex> lock(queueMutex);
+        queue.push_back(move(job));
+    }
+    queueReady.notify_one();
+}
+
+void LeaderboardService::workerLoop() {
+    SessionTrace::nameThread("leaderboard");
+    while (true) {
+        function<void()> job;
+        {
+            unique_lock<mutex> lock(queueMutex);
+            queueReady.wait(lock, [this] { return stopping || !queue.empty(); });
+            if (queue.empty()) {
+                break; // stopping and nothing left
+            }
+            job = move(queue.front());
+            queue.pop_front();
+        }
+        job();
+    }
+}
+
+future<vector<LeaderboardRecord>> LeaderboardService::top(const BoardConfig& config, size_t count) {
+    // std::function needs a copyable closure, so the promise is shared
+    auto result = make_shared<promise<vector<LeaderboardRecord>>>();
+    push([this, result, config, count]() {
+        SessionTrace::Scope trace("top", "leaderboard");
+        FrameWriter request;
+        request.put('T');
+        request.put(static_cast<int32_t>(config.colCount));
+        request.put(static_cast<int32_t>(config.rowCount));
+        request.put(static_cast<int32_t>(config.mineCount));
+        request.put(static_cast<uint32_t>(count));
+
+        vector<uint8_t> response;
+        vector<LeaderboardRecord> records;
+        if (askDaemon(request, response) && FrameReader(response.data(), response.size()).getRecords(records)) {
+            result->set_value(move(records));
+            return;
+        }
+
+        if (!store.open(config)) {
+            cerr << "Failed to open leaderboard file! Creating new one." << endl;
+        }
+        result->set_value(store.top(config, count));
+    });
+    return result->get_future();
+}
+
+future<LeaderboardPage> LeaderboardService::page(const BoardConfig& config, size_t offset, size_t count) {
+    auto result = make_shared<promise<LeaderboardPage>>();
+    push([this, result, config, offset, count]() {
+        SessionTrace::Scope trace("page", "leaderboard");
+        trace.setArg("offset", static_cast<int64_t>(offset));
+        FrameWriter request;
+        request.put('P');
+        request.put(static_cast<int32_t>(config.colCount));
+        request.put(static_cast<int32_t>(config.rowCount));
+        request.put(static_cast<int32_t>(config.mineCount));
+        request.put(static_cast<uint64_t>(offset));
+        request.put(static_cast<uint32_t>(min<size_t>(count, MAX_PAGE_ROWS)));
+
+        vector<uint8_t> response;
+        LeaderboardPage page;
+        if (askDaemon(request, response) && FrameReader(response.data(), response.size()).getPage(page)) {
+            result->set_value(move(page));
+            return;
+        }
+
+        // only reopen for the first block, later blocks are slices of what's in memory
+        if (offset == 0 && !store.open(config)) {
+            cerr << "Failed to open leaderboard file! Creating new one." << endl;
+        }
+        result->set_value(store.page(config, offset, count));
+    });
+    return result->get_future();
+}
+
+future<LeaderboardSubmission> LeaderboardService::submit(const string& playerName, const vector<uint8_t>& replayBytes, size_t count) {
+    auto result = make_shared<promise<LeaderboardSubmission>>();
+    push([this, result, playerName, replayBytes, count]() {
+        SessionTrace::Scope trace("submit", "leaderboard");
+        LeaderboardSubmission submission = {};
+
+        FrameWriter request;
+        request.put('S');
+        request.put(static_cast<uint32_t>(count));
+        request.putString(playerName);
+        request.bytes.insert(request.bytes.end(), replayBytes.begin(), replayBytes.end());
+
+        vector<uint8_t> response;
+        if (askDaemon(request, response) && FrameReader(response.data(), response.size()).getSubmission(submission)) {
+            if (submission.accepted) {
+                // the daemon writes it to the stats file, we only show it
+                stats.mirror(playerName, submission.config, submission.record.timeMillis, submission.record.bbbvPerSecond);
+            } else {
+                cerr << "Leaderboard entry rejected: " << submission.reason << endl;
+            }
+            result->set_value(move(submission));
+            return;
+        }
+
+        // no daemon: verify + insert into the shared file here
+        submission = {};
+        LeaderboardRecord& record = submission.record;
+        submission.accepted = verifySubmission(playerName, replayBytes, submission.config, record, submission.reason);
+        if (submission.accepted) {
+            submission.madeTopK = store.insert(submission.config, record);
+            submission.rank = store.rankOf(submission.config, record.timeMillis, record.order);
+            submission.top = store.top(submission.config, count);
+            stats.record(playerName, submission.config, record.timeMillis, record.bbbvPerSecond, true);
+            if (stats.pendingGames() >= STATS_BATCH_GAMES) {
+                stats.flush();
+            }
+        } else {
+            cerr << "Leaderboard entry rejected: " << submission.reason << endl;
+        }
+        result->set_value(move(submission));
+    });
+    return result->get_future();
+}
+
+void LeaderboardService::recordLoss(const string& playerName, const BoardConfig& config) {
+    push([this, playerName, config]() {
+        SessionTrace::Scope trace("record loss", "stats");
+        stats.record(playerName, config, 0, 0.0, false);
+        if (stats.pendingGames() >= STATS_BATCH_GAMES) {
+            stats.flush();
+        }
+    });
+}
+
+future<PlayerSummary> LeaderboardService::playerSummary(const string& playerName, const BoardConfig& config) {
+    auto result = make_shared<promise<PlayerSummary>>();
+    push([this, result, playerName, config]() {
+        SessionTrace::Scope trace("player summary", "stats");
+        result->set_value(stats.summary(playerName, config));
+    });
+    return result->get_future();
+}
+
+bool LeaderboardService::verifySubmission(const string& playerName, const vector<uint8_t>& replayBytes,
+                                          BoardConfig& config, LeaderboardRecord& record, string& reason) {
+    // the name goes into leaderboard lines and stats keys as is, so it gets the welcome screen's rule
+    // (the replay's own name is checked the same way when it's parsed)
+    if (!isValidPlayerName(playerName)) {
+        reason = "bad player name";
+        return false;
+    }
+
+    // replay the game headless first, nothing the client computed is trusted
+    Replay replay;
+    if (!parseReplay(replayBytes.data(), replayBytes.size(), replay)) {
+        reason = "unreadable replay";
+        return false;
+    }
+    ReplayVerifier verifier;
+    VerifyResult verified = verifier.verify(replay);
+    if (!verified.valid) {
+        reason = verified.reason;
+        return false;
+    }
+    if (verified.playerName != playerName) {
+        reason = "player name mismatch";
+        return false;
+    }
+
+    // 3BV/s uses the exact finish time, efficiency = 3BV / every click the player made
+    int totalClicks = verified.usefulClicks + verified.wastedClicks;
+    record.timeMillis = verified.timeMillis;
+    record.name = playerName;
+    record.bbbv = verified.bbbv;
+    record.bbbvPerSecond = verified.timeMillis > 0 ? verified.bbbv * 1000.0 / verified.timeMillis : 0.0;
+    record.efficiency = totalClicks > 0 ? 100.0 * verified.bbbv / totalClicks : 0.0;
+    record.order = 0;
+    config = {verified.colCount, verified.rowCount, verified.mineCount};
+    return true;
+}
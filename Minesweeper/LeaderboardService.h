@@ -0,0 +1,91 @@
+/*
+purpose: runs all leaderboard work (disk i/o, replay verification) on a background thread
+
+implementation:
+- owns the LeaderboardStore and one worker thread, the game thread only queues requests
+- every request returns a std::future, the UI polls it each frame (wait_for(0)) and
+  shows the result once it's ready, so nothing on the game thread ever waits on disk
+- requests run in order on the worker, so a submit followed by a top() sees the new result
+- submit re-simulates the replay (see ReplayVerifier.h) before anything is stored,
+  the time and stats stored come from that re-simulation
+- per-player stats (PlayerStatsStore, see PlayerStatsStore.h) are kept on the same worker:
+  a win only counts once its submission is verified, with the verified time and 3BV/s
+  (the daemon records it when it verified it, this process just mirrors it for its summaries);
+  losses come from recordLoss, they only add to the games played
+- stats are written STATS_BATCH_GAMES games at a time, and whatever is left when the service stops
+- if the leaderboard daemon is running (see leaderboard_daemon.cpp) every request goes to
+  it over its Unix socket and this process never opens leaderboard.txt; when it isn't,
+  the worker falls back to the shared file store directly
+- a daemon that doesn't answer within DAEMON_TIMEOUT_MILLIS counts as not running: the
+  request goes to the file store and the daemon is left alone for DAEMON_BACKOFF_MILLIS,
+  so the futures always resolve and stopping the service never hangs on it (the daemon
+  doesn't stage a submission whose client hung up, so a timed out win isn't ranked twice)
+*/
+
+#ifndef LEADERBOARDSERVICE_H
+#define LEADERBOARDSERVICE_H
+
+#include "LeaderboardStore.h"
+#include "LeaderboardProtocol.h"
+#include "PlayerStatsStore.h"
+#include <string>
+#include <vector>
+#include <deque>
+#include <functional>
+#include <future>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+#include <cstdint>
+using namespace std;
+
+class LeaderboardService {
+public:
+    static const size_t STATS_BATCH_GAMES = 10;
+    static constexpr int DAEMON_BACKOFF_MILLIS = 10000; // after a timeout, before the daemon is tried again
+
+private:
+    LeaderboardStore store;
+    PlayerStatsStore stats;
+    string socketPath;
+    int daemonFd; // -1 = not connected (only touched by the worker)
+    chrono::steady_clock::time_point daemonRetryTime; // it timed out, local store until then
+
+    thread worker;
+    mutex queueMutex;
+    condition_variable queueReady;
+    deque<function<void()>> queue;
+    bool stopping;
+
+    void push(function<void()> job);
+    void workerLoop();
+    bool askDaemon(const FrameWriter& request, vector<uint8_t>& response);
+
+public:
+    // capacity = entries kept per config when there's no daemon (a file compacted with a bigger K keeps that one)
+    explicit LeaderboardService(const string& path = "leaderboard.txt", const string& socketPath = LEADERBOARD_SOCKET,
+                                size_t capacity = LeaderboardStore::DEFAULT_CAPACITY, const string& statsPath = "player_stats.dat");
+    ~LeaderboardService();
+    LeaderboardService(const LeaderboardService&) = delete;
+    LeaderboardService& operator=(const LeaderboardService&) = delete;
+
+    // the `count` best results for a config
+    future<vector<LeaderboardRecord>> top(const BoardConfig& config, size_t count);
+    // `count` entries from rank `offset` on, for scrolling through a big table
+    future<LeaderboardPage> page(const BoardConfig& config, size_t offset, size_t count);
+    // verify a finished game's replay and add it, then return the config's top `count`
+    future<LeaderboardSubmission> submit(const string& playerName, const vector<uint8_t>& replayBytes, size_t count);
+
+    // add a lost game to the player's stats (wins are recorded by submit once verified)
+    void recordLoss(const string& playerName, const BoardConfig& config);
+    // the player's median / p90 / global standing on a config
+    future<PlayerSummary> playerSummary(const string& playerName, const BoardConfig& config);
+
+    // the re-simulation both this and the daemon run before accepting a win,
+    // fills in the board + record (minus order) or says why not
+    static bool verifySubmission(const string& playerName, const vector<uint8_t>& replayBytes,
+                                 BoardConfig& config, LeaderboardRecord& record, string& reason);
+};
+
+#endif
@@ -0,0 +1,646 @@
+/*
+key components:
+- TopKTable: treap over a vector of nodes, ordered by (time, insertion order), split / merge
+  by key to insert, the rightmost node is the one to evict, subtree sizes find ranks and pages
+- load: maps the file and parses every line in place into the tables
+- open: mapped index lookup (open addressing, linear probing) -> parse that config's section + the tail
+  straight out of the mapped data file
+- parsing: string_view fields + from_chars for integers (strtod on a stack copy for the stats' doubles),
+  no allocation unless a line is admitted
+- insert: under the exclusive lock re-reads the config (merging everyone's results), compacts first
+  if the tail is over its limit, then table push + a single appended line
+- compact: fresh full read -> sections -> <path>.tmp -> rename, then the index the same way
+  (index records the data file's inode, so an index left over from a different file is never trusted)
+- stage / flush: an in-memory insert now, its line goes out with the next batch append (daemon)
+- locking: FileLock on leaderboard.lock, shared for reads, exclusive for insert / compaction
+- line format: cols,rows,mines,ms,name,3bv,3bv/s,efficiency (legacy mm:ss,name[,stats] still parsed)
+*/
+
+#include "LeaderboardStore.h"
+#include "SessionTrace.h"
+#include <fstream>
+#include <sstream>
+#include <iostream>
+#include <charconv>
+#include <iomanip>
+#include <algorithm>
+#include <tuple>
+#include <cstdio>
+#include <cstring>
+#include <cstdlib>
+#include <cctype>
+#include <filesystem>
+#include <sys/stat.h>
+#include <sys/file.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include "MappedFile.h"
+#include "FileLock.h"
+
+static const char INDEX_MAGIC[4] = {'M', 'S', 'L', 'I'};
+static const uint32_t INDEX_VERSION = 2; // 2: header has the capacity
+
+static uint64_t configHash(const BoardConfig& config) {
+    uint64_t hash = static_cast<uint32_t>(config.colCount);
+    hash = hash * 0x9E3779B97F4A7C15ull + static_cast<uint32_t>(config.rowCount);
+    hash = hash * 0x9E3779B97F4A7C15ull + static_cast<uint32_t>(config.mineCount);
+    return hash ^ (hash >> 29);
+}
+
+static bool fileInode(const string& path, uint64_t& inode, uint64_t& size) {
+    struct stat info;
+    if (stat(path.c_str(), &info) != 0) {
+        return false;
+    }
+    inode = info.st_ino;
+    size = info.st_size;
+    return true;
+}
+
+bool BoardConfig::operator<(const BoardConfig& other) const {
+    return tie(colCount, rowCount, mineCount) < tie(other.colCount, other.rowCount, other.mineCount);
+}
+
+bool BoardConfig::operator==(const BoardConfig& other) const {
+    return colCount == other.colCount && rowCount == other.rowCount && mineCount == other.mineCount;
+}
+
+// "a ranks before b"
+static bool ranksBefore(const LeaderboardRecord& a, const LeaderboardRecord& b) {
+    return a.timeMillis != b.timeMillis ? a.timeMillis < b.timeMillis : a.order < b.order;
+}
+
+TopKTable::TopKTable(size_t capacity) : capacity(capacity), root(NIL), worst(NIL), random(0x9E3779B9u) {}
+
+void TopKTable::resize(uint32_t node) {
+    nodes[node].size = 1 + sizeOf(nodes[node].left) + sizeOf(nodes[node].right);
+}
+
+// before = the nodes that rank before key, after = the rest
+void TopKTable::split(uint32_t node, const LeaderboardRecord& key, uint32_t& before, uint32_t& after) {
+    if (node == NIL) {
+        before = after = NIL;
+        return;
+    }
+    if (ranksBefore(nodes[node].record, key)) {
+        split(nodes[node].right, key, nodes[node].right, after);
+        before = node;
+    } else {
+        split(nodes[node].left, key, before, nodes[node].left);
+        after = node;
+    }
+    resize(node);
+}
+
+// every node of `before` ranks before every node of `after`
+uint32_t TopKTable::merge(uint32_t before, uint32_t after) {
+    if (before == NIL) return after;
+    if (after == NIL) return before;
+    if (nodes[before].priority > nodes[after].priority) {
+        nodes[before].right = merge(nodes[before].right, after);
+        resize(before);
+        return before;
+    }
+    nodes[after].left = merge(before, nodes[after].left);
+    resize(after);
+    return after;
+}
+
+// drop the last place of the subtree, returns its new root
+uint32_t TopKTable::removeLast(uint32_t node) {
+    if (nodes[node].right == NIL) {
+        freeNodes.push_back(node);
+        return nodes[node].left;
+    }
+    nodes[node].right = removeLast(nodes[node].right);
+    resize(node);
+    return node;
+}
+
+bool TopKTable::admits(uint32_t timeMillis, uint64_t order) const {
+    if (size() < capacity) return true;
+    if (worst == NIL) return false;
+    const LeaderboardRecord& last = nodes[worst].record;
+    return timeMillis != last.timeMillis ? timeMillis < last.timeMillis : order < last.order;
+}
+
+bool TopKTable::push(LeaderboardRecord record) {
+    bool evicting = size() >= capacity;
+    if (evicting && (worst == NIL || !ranksBefore(record, nodes[worst].record))) {
+        return false;
+    }
+    if (evicting) {
+        root = removeLast(root); // the current K-th place
+    }
+
+    uint32_t node;
+    if (!freeNodes.empty()) {
+        node = freeNodes.back();
+        freeNodes.pop_back();
+        nodes[node].record = move(record);
+    } else {
+        node = static_cast<uint32_t>(nodes.size());
+        nodes.push_back({move(record), NIL, NIL, 1, 0});
+    }
+    random ^= random << 13;
+    random ^= random >> 17;
+    random ^= random << 5;
+    nodes[node].left = nodes[node].right = NIL;
+    nodes[node].size = 1;
+    nodes[node].priority = random;
+
+    uint32_t before, after;
+    split(root, nodes[node].record, before, after);
+    root = merge(merge(before, node), after);
+
+    worst = root;
+    while (nodes[worst].right != NIL) {
+        worst = nodes[worst].right;
+    }
+    return true;
+}
+
+// in order from rank `skip` on, whole subtrees before it are stepped over by their size
+void TopKTable::collect(uint32_t node, size_t& skip, size_t count, vector<LeaderboardRecord>& out) const {
+    if (node == NIL || out.size() >= count) return;
+    if (skip >= nodes[node].size) {
+        skip -= nodes[node].size;
+        return;
+    }
+    collect(nodes[node].left, skip, count, out);
+    if (out.size() >= count) return;
+    if (skip > 0) {
+        skip--;
+    } else {
+        out.push_back(nodes[node].record);
+    }
+    collect(nodes[node].right, skip, count, out);
+}
+
+vector<LeaderboardRecord> TopKTable::slice(size_t offset, size_t count) const {
+    vector<LeaderboardRecord> out;
+    out.reserve(min(count, size() - min(offset, size())));
+    collect(root, offset, count, out);
+    return out;
+}
+
+vector<LeaderboardRecord> TopKTable::sorted() const {
+    return slice(0, size());
+}
+
+size_t TopKTable::rankOf(uint32_t timeMillis, uint64_t order) const {
+    LeaderboardRecord probe = {timeMillis, "", 0, 0.0, 0.0, order};
+    size_t rank = 0;
+    for (uint32_t node = root; node != NIL;) {
+        if (ranksBefore(nodes[node].record, probe)) {
+            rank += sizeOf(nodes[node].left) + 1;
+            node = nodes[node].right;
+        } else {
+            node = nodes[node].left;
+        }
+    }
+    return rank;
+}
+
+LeaderboardStore::LeaderboardStore(const string& path, size_t capacity)
+    : path(path), capacity(capacity), legacyConfig{0, 0, 0}, fullyLoaded(false), dataSize(0), tailStart(0), nextOrder(0) {
+    indexPath = filesystem::path(path).replace_extension(".idx").string();
+    lockPath = filesystem::path(path).replace_extension(".lock").string();
+}
+
+TopKTable& LeaderboardStore::tableFor(const BoardConfig& config) {
+    auto it = boards.find(config);
+    if (it == boards.end()) {
+        it = boards.emplace(config, TopKTable(capacity)).first;
+    }
+    return it->second;
+}
+
+// never rank (and so compact) with fewer rows than the file was last compacted with
+void LeaderboardStore::adoptCapacity(const LeaderboardIndexHeader& header) {
+    if (memcmp(header.magic, INDEX_MAGIC, sizeof(INDEX_MAGIC)) == 0 && header.version == INDEX_VERSION
+        && header.capacity > capacity) {
+        capacity = header.capacity;
+    }
+}
+
+// the name is written into a comma separated line as is, so it can't hold a separator
+static bool storableName(string_view name) {
+    return !name.empty() && name.find_first_of(",\r\n") == string_view::npos;
+}
+
+bool LeaderboardStore::admit(const BoardConfig& config, LeaderboardRecord& record) {
+    if (!storableName(record.name)) {
+        return false; // would come back as a different (or extra) line
+    }
+    record.order = nextOrder++;
+    return tableFor(config).push(record);
+}
+
+// parse a block of mapped lines, keeping only one config's if `only` is set
+void LeaderboardStore::parseLines(string_view text, const BoardConfig* only) {
+    LeaderboardLine line;
+    TopKTable* table = nullptr;
+    BoardConfig tableConfig = {0, 0, 0};
+    while (!text.empty()) {
+        size_t end = text.find('\n');
+        string_view current = text.substr(0, end);
+        text.remove_prefix(end == string_view::npos ? text.size() : end + 1);
+
+        if (current.empty() || !parseLine(current, legacyConfig, line) || (only && !(line.config == *only))) {
+            continue;
+        }
+
+        // lines of one config are usually together (compacted sections), skip the map lookup
+        if (!table || !(line.config == tableConfig)) {
+            table = &tableFor(line.config);
+            tableConfig = line.config;
+        }
+
+        // most lines lose to the current K-th place, those never get past the time
+        uint64_t order = nextOrder++;
+        if (table->admits(line.timeMillis, order) && parseDetails(line)) {
+            table->push({line.timeMillis, string(line.name), line.bbbv, line.bbbvPerSecond, line.efficiency, order});
+        }
+    }
+}
+
+// whole file, caller holds the lock
+bool LeaderboardStore::loadAll(const BoardConfig& legacyConfig) {
+    SessionTrace::Scope trace("load all", "leaderboard io");
+    this->legacyConfig = legacyConfig;
+    boards.clear();
+    fullyLoaded = true;
+    dataSize = 0;
+    tailStart = 0; // no index trusted -> all of it counts as tail until the next compaction
+    nextOrder = 0;
+
+    // even a stale index still knows the K this file was compacted with
+    MappedFile index;
+    if (index.open(indexPath) && index.getSize() >= sizeof(LeaderboardIndexHeader)) {
+        adoptCapacity(*reinterpret_cast<const LeaderboardIndexHeader*>(index.getData()));
+    }
+
+    uint64_t inode = 0, size = 0;
+    if (!fileInode(path, inode, size)) {
+        return false;
+    }
+    MappedFile file;
+    if (size > 0 && !file.open(path)) {
+        return false;
+    }
+    dataSize = file.getSize();
+    parseLines(string_view(reinterpret_cast<const char*>(file.getData()), file.getSize()), nullptr);
+    return true;
+}
+
+// (re)read one config through the index, caller holds the lock.
+// false = no usable index, nothing was changed
+bool LeaderboardStore::readConfig(const BoardConfig& config) {
+    SessionTrace::Scope trace("read config", "leaderboard io");
+    uint64_t inode = 0, size = 0;
+    MappedFile index;
+    MappedFile data;
+    if (!fileInode(path, inode, size) || !data.open(path) || !index.open(indexPath)
+        || index.getSize() < sizeof(LeaderboardIndexHeader)) {
+        return false;
+    }
+
+    const LeaderboardIndexHeader& header = *reinterpret_cast<const LeaderboardIndexHeader*>(index.getData());
+    uint64_t slotCount = header.slotCount;
+    if (memcmp(header.magic, INDEX_MAGIC, sizeof(INDEX_MAGIC)) != 0 || header.version != INDEX_VERSION
+        || slotCount == 0 || (slotCount & (slotCount - 1)) != 0
+        || index.getSize() < sizeof(LeaderboardIndexHeader) + slotCount * sizeof(LeaderboardIndexSlot)
+        || header.dataInode != inode || header.tailStart > data.getSize()) {
+        return false;
+    }
+
+    adoptCapacity(header);
+    legacyConfig = config;
+    boards.erase(config);
+    dataSize = data.getSize();
+    tailStart = header.tailStart;
+
+    const LeaderboardIndexSlot* slots = reinterpret_cast<const LeaderboardIndexSlot*>(index.getData() + sizeof(LeaderboardIndexHeader));
+    const LeaderboardIndexSlot* found = nullptr;
+    for (uint64_t probe = 0, i = configHash(config); probe < slotCount; ++probe, ++i) {
+        const LeaderboardIndexSlot& slot = slots[i & (slotCount - 1)];
+        if (slot.colCount == 0) break;
+        if (slot.colCount == config.colCount && slot.rowCount == config.rowCount && slot.mineCount == config.mineCount) {
+            found = &slot;
+            break;
+        }
+    }
+
+    // only the pages of this config's section (at most K lines) and the tail are ever touched
+    string_view bytes(reinterpret_cast<const char*>(data.getData()), data.getSize());
+    if (found && found->offset + found->length <= tailStart) {
+        parseLines(bytes.substr(found->offset, found->length), &config);
+    }
+    parseLines(bytes.substr(tailStart), &config);
+    return true;
+}
+
+bool LeaderboardStore::load(const BoardConfig& legacyConfig) {
+    FileLock lock(lockPath, false);
+    return loadAll(legacyConfig);
+}
+
+bool LeaderboardStore::open(const BoardConfig& config) {
+    {
+        FileLock lock(lockPath, false);
+        boards.clear();
+        fullyLoaded = false;
+        nextOrder = 0;
+        if (readConfig(config)) {
+            return true;
+        }
+    }
+
+    // no index yet (or no leaderboard at all): read it all once and build one.
+    // someone else may have built it while we swapped locks, so check again first
+    FileLock lock(lockPath, true);
+    if (readConfig(config)) {
+        return true;
+    }
+    bool loaded = loadAll(config);
+    if (loaded) compactLocked();
+    return loaded;
+}
+
+// the whole insert holds the exclusive lock: re-read this config so other processes'
+// results are ranked against, append, and the file can't be renamed away mid append
+bool LeaderboardStore::insert(const BoardConfig& config, LeaderboardRecord& record) {
+    SessionTrace::Scope trace("insert", "leaderboard io");
+    FileLock lock(lockPath, true);
+
+    if (!readConfig(config) && loadAll(fullyLoaded ? legacyConfig : config)) {
+        compactLocked(); // builds the index so the next insert doesn't read everything again
+    }
+
+    // keep the unindexed tail short so opening stays a bounded read
+    if (dataSize - tailStart > TAIL_LIMIT) {
+        loadAll(legacyConfig);
+        compactLocked();
+    }
+
+    if (!admit(config, record)) {
+        return false;
+    }
+    appendLines(formatLine(config, record) + "\n");
+    return true;
+}
+
+// caller holds the exclusive lock
+void LeaderboardStore::appendLines(const string& lines) {
+    ofstream file(path, ios::app | ios::binary);
+    if (!file.is_open()) {
+        cerr << "Failed to open leaderboard file for writing!" << endl;
+        return;
+    }
+    file << lines;
+    file.close();
+    dataSize += lines.size();
+}
+
+bool LeaderboardStore::stage(const BoardConfig& config, LeaderboardRecord& record) {
+    if (!admit(config, record)) {
+        return false;
+    }
+    staged += formatLine(config, record);
+    staged += '\n';
+    return true;
+}
+
+bool LeaderboardStore::flush() {
+    if (staged.empty()) {
+        return true;
+    }
+
+    // one lock + one write for the whole batch
+    SessionTrace::Scope trace("flush", "leaderboard io");
+    FileLock lock(lockPath, true);
+    appendLines(staged);
+    staged.clear();
+
+    // compaction re-reads the file, which now has everything staged so far
+    if (dataSize - tailStart > TAIL_LIMIT) {
+        loadAll(legacyConfig);
+        return compactLocked();
+    }
+    return true;
+}
+
+bool LeaderboardStore::compact() {
+    // always from a fresh read so results other processes added since our load are kept
+    FileLock lock(lockPath, true);
+    loadAll(legacyConfig);
+    return compactLocked();
+}
+
+bool LeaderboardStore::compactLocked() {
+    SessionTrace::Scope trace("compact", "leaderboard io");
+    if (!fullyLoaded) {
+        return false; // would drop every config we didn't read
+    }
+
+    // one contiguous, ranked section per config
+    map<BoardConfig, LeaderboardIndexSlot> sections;
+    string tempPath = path + ".tmp";
+    ofstream file(tempPath, ios::trunc | ios::binary);
+    if (!file.is_open()) {
+        return false;
+    }
+    uint64_t offset = 0;
+    for (const auto& board : boards) {
+        LeaderboardIndexSlot slot = {board.first.colCount, board.first.rowCount, board.first.mineCount, 0, offset, 0};
+        for (const LeaderboardRecord& record : board.second.sorted()) {
+            string line = formatLine(board.first, record) + "\n";
+            file << line;
+            slot.length += line.size();
+            slot.lineCount++;
+        }
+        offset += slot.length;
+        sections[board.first] = slot;
+    }
+    file.close();
+
+    uint64_t inode = 0, size = 0;
+    if (!file || !fileInode(tempPath, inode, size) || rename(tempPath.c_str(), path.c_str()) != 0) {
+        remove(tempPath.c_str());
+        return false;
+    }
+    dataSize = offset;
+    tailStart = offset;
+
+    return writeIndex(sections, inode, offset);
+}
+
+bool LeaderboardStore::writeIndex(const map<BoardConfig, LeaderboardIndexSlot>& sections, uint64_t dataInode, uint64_t sectionEnd) {
+    uint32_t slotCount = 16;
+    while (slotCount < sections.size() * 2) {
+        slotCount *= 2;
+    }
+
+    LeaderboardIndexHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, INDEX_MAGIC, sizeof(INDEX_MAGIC));
+    header.version = INDEX_VERSION;
+    header.slotCount = slotCount;
+    header.configCount = sections.size();
+    header.dataInode = dataInode;
+    header.tailStart = sectionEnd;
+    header.capacity = capacity;
+
+    vector<LeaderboardIndexSlot> slots(slotCount);
+    memset(slots.data(), 0, slots.size() * sizeof(LeaderboardIndexSlot));
+    for (const auto& section : sections) {
+        uint64_t i = configHash(section.first);
+        while (slots[i & (slotCount - 1)].colCount != 0) {
+            i++;
+        }
+        slots[i & (slotCount - 1)] = section.second;
+    }
+
+    string tempPath = indexPath + ".tmp";
+    ofstream file(tempPath, ios::trunc | ios::binary);
+    if (!file.is_open()) {
+        return false;
+    }
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.write(reinterpret_cast<const char*>(slots.data()), slots.size() * sizeof(LeaderboardIndexSlot));
+    file.close();
+
+    if (!file || rename(tempPath.c_str(), indexPath.c_str()) != 0) {
+        remove(tempPath.c_str());
+        return false;
+    }
+    return true;
+}
+
+vector<LeaderboardRecord> LeaderboardStore::top(const BoardConfig& config, size_t count) const {
+    return page(config, 0, count).records;
+}
+
+LeaderboardPage LeaderboardStore::page(const BoardConfig& config, size_t offset, size_t count) const {
+    LeaderboardPage result = {offset, 0, {}};
+    auto it = boards.find(config);
+    if (it == boards.end()) {
+        return result;
+    }
+    result.total = it->second.size();
+    result.records = it->second.slice(offset, count);
+    return result;
+}
+
+size_t LeaderboardStore::rankOf(const BoardConfig& config, uint32_t timeMillis, uint64_t order) const {
+    auto it = boards.find(config);
+    return it == boards.end() ? 0 : it->second.rankOf(timeMillis, order);
+}
+
+string LeaderboardStore::formatLine(const BoardConfig& config, const LeaderboardRecord& record) {
+    ostringstream line;
+    line << config.colCount << "," << config.rowCount << "," << config.mineCount << ","
+         << record.timeMillis << "," << record.name << "," << record.bbbv << ","
+         << fixed << setprecision(3) << record.bbbvPerSecond << ","
+         << setprecision(1) << record.efficiency;
+    return line.str();
+}
+
+// pull the next comma separated field off the front of `rest`
+static string_view nextField(string_view& rest) {
+    size_t comma = rest.find(',');
+    string_view field = rest.substr(0, comma);
+    rest.remove_prefix(comma == string_view::npos ? rest.size() : comma + 1);
+    return field;
+}
+
+// integers only: Apple's libc++ has no floating point from_chars
+template <typename T>
+static bool parseNumber(string_view field, T& value) {
+    auto result = from_chars(field.data(), field.data() + field.size(), value);
+    return result.ec == errc() && result.ptr == field.data() + field.size();
+}
+
+// doubles go through strtod on a nul terminated copy (the mapped field isn't terminated),
+// the stats are a few digits so a small stack buffer is plenty
+static bool parseNumber(string_view field, double& value) {
+    char text[32];
+    // strtod would also skip spaces and take "+1" / "inf", from_chars never did
+    if (field.empty() || field.size() >= sizeof(text) || !(isdigit(static_cast<unsigned char>(field[0])) || field[0] == '-')) {
+        return false;
+    }
+    memcpy(text, field.data(), field.size());
+    text[field.size()] = '\0';
+    char* end = nullptr;
+    value = strtod(text, &end);
+    return end == text + field.size();
+}
+
+// read an integer at pos that has to be followed by `separator`, pos ends up just past it
+template <typename T>
+static bool parseField(const char*& pos, const char* end, T& value, char separator) {
+    auto result = from_chars(pos, end, value);
+    if (result.ec != errc() || result.ptr == end || *result.ptr != separator) {
+        return false;
+    }
+    pos = result.ptr + 1;
+    return true;
+}
+
+// one pass over the front of the line, each number is read straight out of the mapping
+bool LeaderboardStore::parseLine(string_view line, const BoardConfig& legacyConfig, LeaderboardLine& parsed) {
+    if (!line.empty() && line.back() == '\r') {
+        line.remove_suffix(1);
+    }
+    const char* pos = line.data();
+    const char* end = pos + line.size();
+
+    int first = 0;
+    auto result = from_chars(pos, end, first);
+    if (result.ec != errc() || result.ptr == end) {
+        return false;
+    }
+
+    if (*result.ptr == ':') {
+        // legacy: mm:ss,name[,3bv,3bv/s,efficiency]
+        int seconds = 0;
+        pos = result.ptr + 1;
+        if (!parseField(pos, end, seconds, ',')) {
+            return false;
+        }
+        parsed.config = legacyConfig;
+        parsed.timeMillis = static_cast<uint32_t>((first * 60 + seconds) * 1000);
+    } else {
+        // cols,rows,mines,ms,name,3bv,3bv/s,efficiency
+        if (*result.ptr != ',') {
+            return false;
+        }
+        pos = result.ptr + 1;
+        parsed.config.colCount = first;
+        if (!parseField(pos, end, parsed.config.rowCount, ',') || !parseField(pos, end, parsed.config.mineCount, ',')
+            || !parseField(pos, end, parsed.timeMillis, ',')) {
+            return false;
+        }
+    }
+
+    parsed.details = string_view(pos, end - pos);
+    return pos != end;
+}
+
+bool LeaderboardStore::parseDetails(LeaderboardLine& parsed) {
+    string_view rest = parsed.details;
+    parsed.name = nextField(rest);
+    if (!storableName(parsed.name)) {
+        return false;
+    }
+
+    // stats are optional (old lines don't have them), a bad one just reads as 0
+    parsed.bbbv = 0;
+    parsed.bbbvPerSecond = 0.0;
+    parsed.efficiency = 0.0;
+    if (!rest.empty() && !parseNumber(nextField(rest), parsed.bbbv)) parsed.bbbv = 0;
+    if (!rest.empty() && !parseNumber(nextField(rest), parsed.bbbvPerSecond)) parsed.bbbvPerSecond = 0.0;
+    if (!rest.empty() && !parseNumber(nextField(rest), parsed.efficiency)) parsed.efficiency = 0.0;
+    return true;
+}
@@ -0,0 +1,206 @@
+/*
+purpose: storage engine behind the leaderboard
+
+implementation:
+- results are kept per board configuration (cols, rows, mines), times are integer milliseconds
+- each configuration keeps a bounded, always ranked top-K table (TopKTable, a treap with
+  subtree sizes), so inserting is O(log K) and anything slower than the current K-th place
+  is dropped straight away
+- leaderboard.txt is an append log: an insert that makes the top K is appended as one
+  line, nothing is rewritten
+- compaction writes every config's table as one contiguous section (temp file + rename)
+  and builds leaderboard.idx next to it: a hash table of config -> (offset, length)
+- opening one config = hash lookup in the mapped index, then only its section of the
+  mapped data file is read (at most K lines), plus the short unindexed tail of lines appended since compaction;
+  the tail is capped at TAIL_LIMIT bytes, past that the next insert compacts
+- many game processes can share one leaderboard: every access takes an advisory flock()
+  on leaderboard.lock (shared to read, exclusive to insert / compact); an insert re-reads
+  its config under the lock so it's ranked against everyone's results, appends go to
+  whatever file is current, and compaction re-reads the whole file under the lock before
+  its temp file + rename, so nobody's inserts are lost
+- a missing or stale index (different file than it was built for) just means a full
+  load + compaction, which also upgrades older files
+- the index header records the K the file was compacted with, and a store opened with a
+  smaller K takes that one instead, so a game's fallback store never compacts away the rows
+  a daemon with a bigger K kept (K only ever grows for a file)
+- reading never copies the file: it's memory mapped and each line is parsed in place
+  (string_view + from_chars / strtod); only the config + time are parsed up front, the name and
+  stats (and the heap-allocated record) only if the line makes its config's top K
+- paging (page / rankOf) walks the table by subtree size: O(log K) to row n, then showing
+  rows n..n+20 of a big table copies 20 records, not the table
+- old "mm:ss,name[,stats]" lines are still read, they are filed under the config
+  being opened since the old single leaderboard only ever had one board size
+*/
+
+#ifndef LEADERBOARDSTORE_H
+#define LEADERBOARDSTORE_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <map>
+#include <cstdint>
+using namespace std;
+
+struct BoardConfig {
+    int colCount;
+    int rowCount;
+    int mineCount;
+
+    bool operator<(const BoardConfig& other) const;
+    bool operator==(const BoardConfig& other) const;
+};
+
+struct LeaderboardRecord {
+    uint32_t timeMillis;
+    string name;
+    int bbbv;             // 0 for old entries saved before stats existed
+    double bbbvPerSecond;
+    double efficiency;    // percent, 3BV / total clicks
+    uint64_t order;       // insertion order, earlier wins a tie
+};
+
+// one parsed line, pointing into the mapped file (nothing owned)
+struct LeaderboardLine {
+    BoardConfig config;
+    uint32_t timeMillis;
+    string_view details; // name + stats, only parsed (parseDetails) once a line is admitted
+    string_view name;
+    int bbbv;
+    double bbbvPerSecond;
+    double efficiency;
+};
+
+// one slice of a config's ranked table
+struct LeaderboardPage {
+    size_t offset;                    // rank (0 based) of records[0]
+    size_t total;                     // entries in the whole table
+    vector<LeaderboardRecord> records;
+};
+
+// K best (lowest time) records, kept ranked in a treap ordered by (time, insertion order):
+// every node knows its subtree's size, so admitting a record, evicting the K-th place, the
+// rank of a record and the first row of any page are all O(log K), no matter how big K is
+class TopKTable {
+private:
+    static constexpr uint32_t NIL = UINT32_MAX;
+
+    struct Node {
+        LeaderboardRecord record;
+        uint32_t left;     // node indices, NIL = none
+        uint32_t right;
+        uint32_t size;     // nodes in this subtree
+        uint32_t priority; // random, parents have higher ones (keeps the tree balanced)
+    };
+
+    size_t capacity;
+    vector<Node> nodes;         // evicted nodes are reused (freeNodes), nothing is allocated per record once full
+    vector<uint32_t> freeNodes;
+    uint32_t root;
+    uint32_t worst;             // rightmost node = the current K-th place
+    uint32_t random;            // xorshift state for the priorities
+
+    uint32_t sizeOf(uint32_t node) const { return node == NIL ? 0 : nodes[node].size; }
+    void resize(uint32_t node);
+    void split(uint32_t node, const LeaderboardRecord& key, uint32_t& before, uint32_t& after);
+    uint32_t merge(uint32_t before, uint32_t after);
+    uint32_t removeLast(uint32_t node);
+    void collect(uint32_t node, size_t& skip, size_t count, vector<LeaderboardRecord>& out) const;
+
+public:
+    explicit TopKTable(size_t capacity = 0);
+
+    bool admits(uint32_t timeMillis, uint64_t order) const; // would push() keep it
+    bool push(LeaderboardRecord record); // true if it made the top K
+    size_t size() const { return sizeOf(root); }
+    vector<LeaderboardRecord> sorted() const; // fastest first
+    // `count` records from rank `offset` on, O(log K + count)
+    vector<LeaderboardRecord> slice(size_t offset, size_t count) const;
+    // how many records rank before (timeMillis, order)
+    size_t rankOf(uint32_t timeMillis, uint64_t order) const;
+};
+
+// on-disk index layout (leaderboard.idx)
+struct LeaderboardIndexHeader {
+    char magic[4];        // "MSLI"
+    uint32_t version;
+    uint32_t slotCount;   // power of two, at most half full
+    uint32_t configCount;
+    uint64_t dataInode;   // which leaderboard.txt this was built for
+    uint64_t tailStart;   // end of the indexed sections = where appended lines start
+    uint64_t capacity;    // K the sections were compacted with
+};
+
+struct LeaderboardIndexSlot {
+    int32_t colCount;     // 0 = empty slot
+    int32_t rowCount;
+    int32_t mineCount;
+    uint32_t lineCount;
+    uint64_t offset;
+    uint64_t length;
+};
+
+class LeaderboardStore {
+public:
+    static const size_t DEFAULT_CAPACITY = 100;
+    static const uint64_t TAIL_LIMIT = 64 * 1024; // unindexed bytes allowed before compacting
+
+private:
+    string path;
+    string indexPath;
+    string lockPath;
+    size_t capacity;    // grows to the file's K if that's bigger (see adoptCapacity)
+    map<BoardConfig, TopKTable> boards;
+    BoardConfig legacyConfig;
+    bool fullyLoaded;   // false = only the opened config is in memory
+    uint64_t dataSize;  // size of leaderboard.txt as far as we know
+    uint64_t tailStart;
+    uint64_t nextOrder;
+    string staged;      // lines staged but not flushed yet
+
+    TopKTable& tableFor(const BoardConfig& config);
+    bool admit(const BoardConfig& config, LeaderboardRecord& record);
+    void adoptCapacity(const LeaderboardIndexHeader& header);
+    void parseLines(string_view text, const BoardConfig* only);
+
+    // these expect the caller to hold the lock
+    bool loadAll(const BoardConfig& legacyConfig);
+    bool readConfig(const BoardConfig& config);
+    bool compactLocked();
+    void appendLines(const string& lines);
+    bool writeIndex(const map<BoardConfig, LeaderboardIndexSlot>& sections, uint64_t dataInode, uint64_t sectionEnd);
+
+public:
+    LeaderboardStore(const string& path = "leaderboard.txt", size_t capacity = DEFAULT_CAPACITY);
+
+    // read every config (used for compaction / tools)
+    bool load(const BoardConfig& legacyConfig);
+    // read just one config through the index (falls back to load + compact without one)
+    bool open(const BoardConfig& config);
+
+    // returns true if the record made its config's top K (then it's appended to the file),
+    // record.order is filled in either way. only this config is re-read from disk first,
+    // other configs in memory can be behind other processes until reopened.
+    // an empty name or one with a comma / line break is refused (false, no order)
+    bool insert(const BoardConfig& config, LeaderboardRecord& record);
+    bool compact();
+
+    // for a long running owner (the leaderboard daemon): stage() ranks a record in memory
+    // right away (same return as insert), flush() appends everything staged in one locked write
+    bool stage(const BoardConfig& config, LeaderboardRecord& record);
+    bool flush();
+
+    vector<LeaderboardRecord> top(const BoardConfig& config, size_t count) const;
+    // `count` entries starting at rank `offset`, only that slice is copied
+    LeaderboardPage page(const BoardConfig& config, size_t offset, size_t count) const;
+    // 0 based rank of a record (by time + order) in its config's table
+    size_t rankOf(const BoardConfig& config, uint32_t timeMillis, uint64_t order) const;
+
+    // the name is written as is: insert / stage refuse names that would split the line
+    static string formatLine(const BoardConfig& config, const LeaderboardRecord& record);
+    // parseLine reads the config + time, parseDetails the name + stats after it
+    static bool parseLine(string_view line, const BoardConfig& legacyConfig, LeaderboardLine& parsed);
+    static bool parseDetails(LeaderboardLine& parsed);
+};
+
+#endif
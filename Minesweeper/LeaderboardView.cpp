@@ -0,0 +1,302 @@
+/*
+key components:
+- glyph cache: printable ASCII geometry from the font once, anything else is drawn as '?'
+- block cache: BLOCK_ROWS rows per service.page() request, LRU eviction past MAX_BLOCKS,
+  one request per block at a time
+- layout: rank | time | name (clipped) | 3BV/s, written straight into the vertex array
+  as two triangles per glyph, only for the rows on screen
+- scrolling: clamped to the table, redraws only mark the vertices dirty
+*/
+
+#include "LeaderboardView.h"
+#include <algorithm>
+#include <cstdio>
+using namespace std;
+
+static const sf::Color ROW_COLOR(255, 255, 255);
+static const sf::Color HEADER_COLOR(200, 200, 255);
+static const sf::Color MISSING_COLOR(150, 150, 200);
+static const sf::Color HIGHLIGHT_COLOR(255, 255, 0);
+static const float SCROLLBAR_WIDTH = 6.0f;
+static const int WHEEL_ROWS = 3;
+
+LeaderboardView::LeaderboardView(const sf::Font& font, unsigned characterSize, const sf::FloatRect& area, LeaderboardService& service)
+    : font(font), characterSize(characterSize), area(area), service(service), config{0, 0, 0},
+      total(0), totalKnown(false), firstRow(0), highlightOrder(0), hasHighlight(false),
+      useCounter(0), vertices(sf::Triangles), dirty(true) {
+
+    cacheGlyphs();
+
+    scrollTrack.setFillColor(sf::Color(0, 0, 160));
+    scrollTrack.setPosition(area.left + area.width - SCROLLBAR_WIDTH, area.top + rowHeight);
+    scrollTrack.setSize(sf::Vector2f(SCROLLBAR_WIDTH, area.height - rowHeight));
+    scrollThumb.setFillColor(sf::Color(200, 200, 255));
+}
+
+void LeaderboardView::cacheGlyphs() {
+    // looking every glyph up here also puts them all on the font's texture page now,
+    // so it doesn't grow (and the texture rects stay put) while the window is open
+    for (int i = 0; i < GLYPH_COUNT; ++i) {
+        const sf::Glyph& glyph = font.getGlyph(FIRST_GLYPH + i, characterSize, false);
+
+        // same one pixel padding sf::Text uses so edges don't get clipped
+        const float padding = 1.0f;
+        GlyphGeometry& geometry = glyphs[i];
+        geometry.quad = sf::FloatRect(glyph.bounds.left - padding, glyph.bounds.top - padding,
+                                      glyph.bounds.width + 2 * padding, glyph.bounds.height + 2 * padding);
+        geometry.texture = sf::FloatRect(glyph.textureRect.left - padding, glyph.textureRect.top - padding,
+                                         glyph.textureRect.width + 2 * padding, glyph.textureRect.height + 2 * padding);
+        geometry.advance = glyph.advance;
+    }
+    rowHeight = font.getLineSpacing(characterSize);
+    if (rowHeight <= 0) {
+        rowHeight = characterSize * 1.2f;
+    }
+}
+
+// rows that fit under the header line
+size_t LeaderboardView::visibleRows() const {
+    return static_cast<size_t>(max(1.0f, area.height / rowHeight - 1));
+}
+
+void LeaderboardView::scrollTo(long long row) {
+    long long last = totalKnown ? static_cast<long long>(total) - static_cast<long long>(visibleRows()) : 0;
+    row = max(0LL, min(row, last));
+    if (static_cast<size_t>(row) != firstRow) {
+        firstRow = row;
+        dirty = true;
+    }
+}
+
+void LeaderboardView::show(const BoardConfig& newConfig) {
+    config = newConfig;
+    blocks.clear();
+    pending.clear(); // anything still on its way is for the old table, just let it finish
+    total = 0;
+    totalKnown = false;
+    firstRow = 0;
+    hasHighlight = false;
+    status.clear();
+    request(0); // always first, it's the one that (re)opens the config without a daemon
+    dirty = true;
+}
+
+void LeaderboardView::showRecord(const BoardConfig& newConfig, uint64_t order, size_t rank) {
+    show(newConfig);
+    highlightOrder = order;
+    hasHighlight = true;
+    // centred on the record, clamped to the table once the first block says how big it is
+    firstRow = rank > visibleRows() / 2 ? rank - visibleRows() / 2 : 0;
+}
+
+void LeaderboardView::setStatus(const string& text) {
+    status = text;
+    dirty = true;
+}
+
+void LeaderboardView::request(size_t block) {
+    if (blocks.count(block) || pending.count(block)) {
+        return;
+    }
+    pending.emplace(block, service.page(config, block * BLOCK_ROWS, BLOCK_ROWS));
+}
+
+// the row at `rank` if its block is here, otherwise asks for the block and returns null
+const LeaderboardRecord* LeaderboardView::rowAt(size_t rank) {
+    size_t block = rank / BLOCK_ROWS;
+    auto it = blocks.find(block);
+    if (it == blocks.end()) {
+        request(block);
+        return nullptr;
+    }
+    it->second.lastUse = useCounter;
+    size_t index = rank % BLOCK_ROWS;
+    return index < it->second.rows.size() ? &it->second.rows[index] : nullptr;
+}
+
+void LeaderboardView::update() {
+    for (auto it = pending.begin(); it != pending.end();) {
+        if (it->second.wait_for(chrono::seconds(0)) != future_status::ready) {
+            ++it;
+            continue;
+        }
+        LeaderboardPage page = it->second.get();
+        if (!totalKnown || page.total != total) {
+            total = page.total;
+            totalKnown = true;
+            scrollTo(firstRow); // table may have shrunk under us
+        }
+        blocks[it->first] = {move(page.records), useCounter};
+        it = pending.erase(it);
+        dirty = true;
+    }
+
+    // evict the least recently drawn blocks
+    while (blocks.size() > MAX_BLOCKS) {
+        auto oldest = blocks.begin();
+        for (auto it = blocks.begin(); it != blocks.end(); ++it) {
+            if (it->second.lastUse < oldest->second.lastUse) {
+                oldest = it;
+            }
+        }
+        blocks.erase(oldest);
+    }
+}
+
+void LeaderboardView::handleEvent(const sf::Event& event) {
+    long long page = static_cast<long long>(visibleRows());
+    if (event.type == sf::Event::MouseWheelScrolled && event.mouseWheelScroll.wheel == sf::Mouse::VerticalWheel) {
+        scrollTo(static_cast<long long>(firstRow) - static_cast<long long>(event.mouseWheelScroll.delta * WHEEL_ROWS));
+    } else if (event.type == sf::Event::KeyPressed) {
+        switch (event.key.code) {
+            case sf::Keyboard::Up:       scrollTo(static_cast<long long>(firstRow) - 1); break;
+            case sf::Keyboard::Down:     scrollTo(static_cast<long long>(firstRow) + 1); break;
+            case sf::Keyboard::PageUp:   scrollTo(static_cast<long long>(firstRow) - page); break;
+            case sf::Keyboard::PageDown: scrollTo(static_cast<long long>(firstRow) + page); break;
+            case sf::Keyboard::Home:     scrollTo(0); break;
+            case sf::Keyboard::End:      scrollTo(static_cast<long long>(total)); break;
+            default: break;
+        }
+    }
+}
+
+float LeaderboardView::textWidth(const char* text) const {
+    float width = 0;
+    for (; *text; ++text) {
+        int c = static_cast<unsigned char>(*text);
+        width += glyphs[(c >= FIRST_GLYPH && c < FIRST_GLYPH + GLYPH_COUNT ? c : '?') - FIRST_GLYPH].advance;
+    }
+    return width;
+}
+
+// lays out text on a baseline starting at x, stops before maxX, returns where the pen ended
+float LeaderboardView::appendText(const char* text, float x, float baseline, float maxX, const sf::Color& color) {
+    for (; *text; ++text) {
+        int c = static_cast<unsigned char>(*text);
+        const GlyphGeometry& glyph = glyphs[(c >= FIRST_GLYPH && c < FIRST_GLYPH + GLYPH_COUNT ? c : '?') - FIRST_GLYPH];
+        if (x + glyph.advance > maxX) {
+            break;
+        }
+
+        if (c != ' ') {
+            float left = x + glyph.quad.left;
+            float top = baseline + glyph.quad.top;
+            float right = left + glyph.quad.width;
+            float bottom = top + glyph.quad.height;
+            float u1 = glyph.texture.left;
+            float v1 = glyph.texture.top;
+            float u2 = u1 + glyph.texture.width;
+            float v2 = v1 + glyph.texture.height;
+
+            sf::Vertex corners[4];
+            corners[0] = sf::Vertex(sf::Vector2f(left, top), color);
+            corners[1] = sf::Vertex(sf::Vector2f(right, top), color);
+            corners[2] = sf::Vertex(sf::Vector2f(left, bottom), color);
+            corners[3] = sf::Vertex(sf::Vector2f(right, bottom), color);
+            corners[0].texCoords = sf::Vector2f(u1, v1);
+            corners[1].texCoords = sf::Vector2f(u2, v1);
+            corners[2].texCoords = sf::Vector2f(u1, v2);
+            corners[3].texCoords = sf::Vector2f(u2, v2);
+
+            vertices.append(corners[0]);
+            vertices.append(corners[1]);
+            vertices.append(corners[2]);
+            vertices.append(corners[2]);
+            vertices.append(corners[1]);
+            vertices.append(corners[3]);
+        }
+        x += glyph.advance;
+    }
+    return x;
+}
+
+void LeaderboardView::rebuild() {
+    vertices.clear(); // keeps its storage, steady scrolling doesn't allocate
+
+    float right = area.left + area.width - SCROLLBAR_WIDTH - 4;
+    float baseline = area.top + characterSize;
+
+    if (!status.empty()) {
+        appendText(status.c_str(), area.left, baseline + rowHeight, right, ROW_COLOR);
+        return;
+    }
+
+    // column positions come from the digit width so they line up for any font
+    float digit = textWidth("0");
+    float rankRight = area.left + digit * 8;   // "1000000."
+    float timeLeft = rankRight + digit;
+    float nameLeft = timeLeft + textWidth("00:00.000") + digit;
+    float statsLeft = right - textWidth("000.000");
+
+    appendText("#", rankRight - textWidth("#"), baseline, right, HEADER_COLOR);
+    appendText("time", timeLeft, baseline, right, HEADER_COLOR);
+    appendText("name", nameLeft, baseline, statsLeft, HEADER_COLOR);
+    appendText("3BV/s", right - textWidth("3BV/s"), baseline, right, HEADER_COLOR);
+
+    if (!totalKnown) {
+        appendText("loading...", timeLeft, baseline + rowHeight, right, ROW_COLOR);
+        return;
+    }
+    if (total == 0) {
+        appendText("no results yet", timeLeft, baseline + rowHeight, right, ROW_COLOR);
+        return;
+    }
+
+    char field[64];
+    size_t lastRow = min(total, firstRow + visibleRows());
+    for (size_t rank = firstRow; rank < lastRow; ++rank) {
+        baseline += rowHeight;
+
+        snprintf(field, sizeof(field), "%zu.", rank + 1);
+        const LeaderboardRecord* record = rowAt(rank);
+        bool highlighted = record && hasHighlight && record->order == highlightOrder;
+        sf::Color color = !record ? MISSING_COLOR : highlighted ? HIGHLIGHT_COLOR : ROW_COLOR;
+        appendText(field, rankRight - textWidth(field), baseline, right, color);
+
+        if (!record) {
+            appendText("...", timeLeft, baseline, right, color);
+            continue;
+        }
+
+        // mm:ss.mmm, minutes just keep growing past 99
+        snprintf(field, sizeof(field), "%02u:%02u.%03u", record->timeMillis / 60000, record->timeMillis / 1000 % 60, record->timeMillis % 1000);
+        appendText(field, timeLeft, baseline, right, color);
+
+        float nameEnd = appendText(record->name.c_str(), nameLeft, baseline, statsLeft - digit, color);
+        if (highlighted) {
+            appendText("*", nameEnd, baseline, statsLeft, color);
+        }
+
+        if (record->bbbv > 0) {
+            snprintf(field, sizeof(field), "%.3f", record->bbbvPerSecond);
+            appendText(field, right - textWidth(field), baseline, right, color);
+        }
+    }
+
+    // ask for the block past the bottom too so scrolling down rarely shows "..."
+    if (lastRow < total) {
+        request(lastRow / BLOCK_ROWS);
+    }
+
+    // thumb size = share of the table on screen, at least a grabbable height
+    sf::Vector2f trackSize = scrollTrack.getSize();
+    float shown = static_cast<float>(lastRow - firstRow) / total;
+    float thumbHeight = max(8.0f, trackSize.y * shown);
+    size_t scrollable = total - (lastRow - firstRow);
+    float position = scrollable > 0 ? static_cast<float>(firstRow) / scrollable : 0.0f;
+    scrollThumb.setSize(sf::Vector2f(SCROLLBAR_WIDTH, thumbHeight));
+    scrollThumb.setPosition(scrollTrack.getPosition().x, scrollTrack.getPosition().y + (trackSize.y - thumbHeight) * position);
+}
+
+void LeaderboardView::draw(sf::RenderTarget& target, FrameProfiler& profiler) {
+    if (dirty) {
+        useCounter++;
+        rebuild();
+        dirty = false;
+    }
+    if (status.empty() && totalKnown && total > visibleRows()) {
+        profiler.draw(target, scrollTrack);
+        profiler.draw(target, scrollThumb);
+    }
+    profiler.draw(target, vertices, sf::RenderStates(&font.getTexture(characterSize)));
+}
@@ -0,0 +1,101 @@
+/*
+purpose: scrollable, paginated view of one config's leaderboard table, used by LeaderboardScene
+
+implementation:
+- the table can be any size (the daemon can keep a million entries per config), the view
+  never holds or lays out more than it shows
+- rows are fetched from the LeaderboardService in blocks of BLOCK_ROWS, at most MAX_BLOCKS
+  are cached (least recently used goes first); a row that isn't there yet shows "..."
+  and is filled in once its block's future is ready, nothing ever waits on the worker
+- glyph geometry (quad + texture rect + advance) for printable ASCII is looked up once
+  in the constructor, so laying out a row is just table lookups, no sf::Text per row
+- all visible rows go into one vertex array (one draw call), rebuilt only when something
+  changed (scrolling, a block arriving, a new highlight), otherwise the same vertices
+  are drawn again
+- mouse wheel, up / down, page up / page down, home / end scroll; a scrollbar on the
+  right shows where in the table the view is
+*/
+
+#ifndef LEADERBOARDVIEW_H
+#define LEADERBOARDVIEW_H
+
+#include "LeaderboardStore.h"
+#include "LeaderboardService.h"
+#include "FrameProfiler.h"
+#include <SFML/Graphics.hpp>
+#include <string>
+#include <vector>
+#include <map>
+#include <future>
+#include <cstdint>
+using namespace std;
+
+class LeaderboardView {
+public:
+    static const size_t BLOCK_ROWS = 50;
+    static const size_t MAX_BLOCKS = 16;
+
+private:
+    static const int FIRST_GLYPH = 32;  // ' '
+    static const int GLYPH_COUNT = 95;  // up to '~'
+
+    // what a glyph contributes to a line, relative to the pen position on the baseline
+    struct GlyphGeometry {
+        sf::FloatRect quad;
+        sf::FloatRect texture;
+        float advance;
+    };
+
+    struct Block {
+        vector<LeaderboardRecord> rows;
+        uint64_t lastUse;
+    };
+
+    const sf::Font& font;
+    unsigned characterSize;
+    sf::FloatRect area;
+    float rowHeight;
+    GlyphGeometry glyphs[GLYPH_COUNT];
+
+    LeaderboardService& service;
+    BoardConfig config;
+    size_t total;          // entries in the table, as of the last block received
+    bool totalKnown;
+    size_t firstRow;       // rank of the top visible row
+    uint64_t highlightOrder;
+    bool hasHighlight;
+    string status;         // shown instead of the table while not empty
+
+    map<size_t, Block> blocks;                      // block number -> its rows
+    map<size_t, future<LeaderboardPage>> pending;   // blocks on their way
+    uint64_t useCounter;
+
+    sf::VertexArray vertices;
+    sf::RectangleShape scrollTrack;
+    sf::RectangleShape scrollThumb;
+    bool dirty;
+
+    void cacheGlyphs();
+    size_t visibleRows() const;
+    void scrollTo(long long row);
+    void request(size_t block);
+    const LeaderboardRecord* rowAt(size_t rank);
+    float textWidth(const char* text) const;
+    float appendText(const char* text, float x, float baseline, float maxX, const sf::Color& color);
+    void rebuild();
+
+public:
+    LeaderboardView(const sf::Font& font, unsigned characterSize, const sf::FloatRect& area, LeaderboardService& service);
+
+    // start over on a config's table (drops cached rows, they may be stale)
+    void show(const BoardConfig& config);
+    // same, then highlight the record with this order and scroll so its rank is in view
+    void showRecord(const BoardConfig& config, uint64_t order, size_t rank);
+    void setStatus(const string& text);
+
+    void handleEvent(const sf::Event& event);
+    void update(); // takes blocks that have arrived, call once a frame
+    void draw(sf::RenderTarget& target, FrameProfiler& profiler);
+};
+
+#endif
@@ -0,0 +1,40 @@
+/*
+purpose: small wrapper around a memory-mapped file (POSIX mmap)
+
+implementation:
+- maps a whole file into memory so its bytes can be used in place, no read/parse step
+- private mappings are copy-on-write: writes only change our memory, never the file
+- unmaps automatically when destroyed, can be moved but not copied
+*/
+
+#ifndef MAPPEDFILE_H
+#define MAPPEDFILE_H
+
+#include <string>
+#include <cstddef>
+#include <cstdint>
+using namespace std;
+
+class MappedFile {
+private:
+    uint8_t* data;
+    size_t size;
+
+public:
+    MappedFile();
+    ~MappedFile();
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    // map the whole file, writable = private copy-on-write pages we can modify
+    bool open(const string& path, bool writable = false);
+    void close();
+
+    bool isOpen() const;
+    uint8_t* getData() const;
+    size_t getSize() const;
+};
+
+#endif
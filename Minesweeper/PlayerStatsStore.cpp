@@ -0,0 +1,255 @@
+/*
+key components:
+- record: counters + digest adds for the player's entry and the config-wide one, in memory
+  and in the unsaved set
+- flush: exclusive FileLock -> read the current file -> merge the unsaved digests in ->
+  <path>.tmp -> rename; stops before writing if the current file exists but can't be read
+- file format: "MSPS", version, entry count, then per entry the name, config, counters and
+  both digests as (compression, min, max, centroid count, centroids); written with the
+  leaderboard protocol's FrameWriter / FrameReader, read through a MappedFile
+- summary: hash lookups + quantile / cdf on already compressed digests
+*/
+
+#include "PlayerStatsStore.h"
+#include "LeaderboardProtocol.h"
+#include "MappedFile.h"
+#include "FileLock.h"
+#include "SessionTrace.h"
+#include <iostream>
+#include <cstdio>
+#include <cmath>
+#include <cerrno>
+#include <cstring>
+#include <sys/stat.h>
+
+static const char STATS_MAGIC[4] = {'M', 'S', 'P', 'S'};
+static const uint32_t STATS_VERSION = 1;
+
+bool PlayerStatsStore::Key::operator==(const Key& other) const {
+    return config == other.config && name == other.name;
+}
+
+size_t PlayerStatsStore::KeyHash::operator()(const Key& key) const {
+    size_t hash = std::hash<string>()(key.name);
+    hash = hash * 0x9E3779B97F4A7C15ull + static_cast<uint32_t>(key.config.colCount);
+    hash = hash * 0x9E3779B97F4A7C15ull + static_cast<uint32_t>(key.config.rowCount);
+    hash = hash * 0x9E3779B97F4A7C15ull + static_cast<uint32_t>(key.config.mineCount);
+    return hash ^ (hash >> 29);
+}
+
+PlayerStatsStore::PlayerStatsStore(const string& path)
+    : path(path), lockPath(path + ".lock"), unsavedGames(0), loaded(false) {}
+
+void PlayerStatsStore::addGame(EntryMap& map, const Key& key, uint32_t timeMillis, double bbbvPerSecond, bool won) {
+    Entry& entry = map[key];
+    entry.games++;
+    if (won) {
+        entry.wins++;
+        entry.times.add(timeMillis);
+        entry.bbbvPerSecond.add(bbbvPerSecond);
+    }
+}
+
+void PlayerStatsStore::mergeEntries(EntryMap& into, const EntryMap& from) {
+    for (const auto& item : from) {
+        Entry& entry = into[item.first];
+        entry.games += item.second.games;
+        entry.wins += item.second.wins;
+        entry.times.merge(item.second.times);
+        entry.bbbvPerSecond.merge(item.second.bbbvPerSecond);
+    }
+}
+
+static void putDigest(FrameWriter& writer, TDigest digest) {
+    digest.compress();
+    writer.put(digest.getCompression());
+    writer.put(digest.getMin());
+    writer.put(digest.getMax());
+    writer.put(static_cast<uint32_t>(digest.getCentroids().size()));
+    for (const Centroid& centroid : digest.getCentroids()) {
+        writer.put(centroid.mean);
+        writer.put(centroid.weight);
+    }
+}
+
+static bool getDigest(FrameReader& reader, TDigest& digest) {
+    double compression, minValue, maxValue;
+    uint32_t count;
+    if (!reader.get(compression) || !reader.get(minValue) || !reader.get(maxValue) || !reader.get(count)
+        || !(compression > 0) || count > reader.remainingSize() / sizeof(Centroid)) {
+        return false;
+    }
+    vector<Centroid> centroids(count);
+    for (Centroid& centroid : centroids) {
+        if (!reader.get(centroid.mean) || !reader.get(centroid.weight)) {
+            return false;
+        }
+    }
+    digest = TDigest::fromCentroids(compression, centroids, minValue, maxValue);
+    return true;
+}
+
+// caller holds the lock; a missing (or empty) file is just an empty one, any other
+// failure is false so flush() doesn't replace entries it never saw
+bool PlayerStatsStore::readFile(EntryMap& map) const {
+    map.clear();
+    struct stat info;
+    if (stat(path.c_str(), &info) != 0) {
+        if (errno == ENOENT) {
+            return true;
+        }
+        cerr << "Can't read " << path << ": " << strerror(errno) << endl;
+        return false;
+    }
+    MappedFile file;
+    if (info.st_size == 0) {
+        return true;
+    }
+    if (!file.open(path)) {
+        cerr << "Can't read " << path << endl;
+        return false;
+    }
+
+    FrameReader reader(file.getData(), file.getSize());
+    char magic[4];
+    uint32_t version, count;
+    if (!reader.get(magic) || memcmp(magic, STATS_MAGIC, sizeof(magic)) != 0
+        || !reader.get(version) || version != STATS_VERSION || !reader.get(count)) {
+        cerr << "Ignoring unreadable " << path << endl;
+        return false;
+    }
+    for (uint32_t i = 0; i < count; ++i) {
+        Key key;
+        int32_t colCount, rowCount, mineCount;
+        Entry entry;
+        if (!reader.getString(key.name) || !reader.get(colCount) || !reader.get(rowCount) || !reader.get(mineCount)
+            || !reader.get(entry.games) || !reader.get(entry.wins)
+            || !getDigest(reader, entry.times) || !getDigest(reader, entry.bbbvPerSecond)) {
+            cerr << "Ignoring damaged end of " << path << endl;
+            return false;
+        }
+        key.config = {colCount, rowCount, mineCount};
+        map[move(key)] = move(entry);
+    }
+    return true;
+}
+
+// caller holds the lock
+bool PlayerStatsStore::writeFile(const EntryMap& map) const {
+    FrameWriter writer;
+    writer.put(STATS_MAGIC);
+    writer.put(STATS_VERSION);
+    writer.put(static_cast<uint32_t>(map.size()));
+    for (const auto& item : map) {
+        writer.putString(item.first.name);
+        writer.put(static_cast<int32_t>(item.first.config.colCount));
+        writer.put(static_cast<int32_t>(item.first.config.rowCount));
+        writer.put(static_cast<int32_t>(item.first.config.mineCount));
+        writer.put(item.second.games);
+        writer.put(item.second.wins);
+        putDigest(writer, item.second.times);
+        putDigest(writer, item.second.bbbvPerSecond);
+    }
+
+    string tempPath = path + ".tmp";
+    FILE* file = fopen(tempPath.c_str(), "wb");
+    if (!file) {
+        return false;
+    }
+    bool written = fwrite(writer.bytes.data(), 1, writer.bytes.size(), file) == writer.bytes.size();
+    written = fclose(file) == 0 && written;
+    return written && rename(tempPath.c_str(), path.c_str()) == 0;
+}
+
+bool PlayerStatsStore::load() {
+    SessionTrace::Scope trace("load stats", "stats io");
+    FileLock lock(lockPath, false);
+    EntryMap fresh;
+    bool ok = readFile(fresh);
+    mergeEntries(fresh, unsaved); // our games that aren't in the file yet
+    entries = move(fresh);
+    loaded = true;
+    return ok;
+}
+
+void PlayerStatsStore::record(const string& playerName, const BoardConfig& config, uint32_t timeMillis, double bbbvPerSecond, bool won) {
+    if (playerName.empty()) {
+        return; // that key is everyone's, the game would count twice
+    }
+    if (!loaded) {
+        load();
+    }
+    Key player = {playerName, config};
+    Key everyone = {"", config};
+    addGame(entries, player, timeMillis, bbbvPerSecond, won);
+    addGame(entries, everyone, timeMillis, bbbvPerSecond, won);
+    addGame(unsaved, player, timeMillis, bbbvPerSecond, won);
+    addGame(unsaved, everyone, timeMillis, bbbvPerSecond, won);
+    unsavedGames++;
+}
+
+void PlayerStatsStore::mirror(const string& playerName, const BoardConfig& config, uint32_t timeMillis, double bbbvPerSecond) {
+    if (playerName.empty()) {
+        return;
+    }
+    if (!loaded) {
+        load();
+    }
+    addGame(entries, {playerName, config}, timeMillis, bbbvPerSecond, true);
+    addGame(entries, {"", config}, timeMillis, bbbvPerSecond, true);
+}
+
+bool PlayerStatsStore::flush() {
+    if (unsaved.empty()) {
+        return true;
+    }
+    SessionTrace::Scope trace("flush stats", "stats io");
+    FileLock lock(lockPath, true);
+    EntryMap fresh;
+    if (!readFile(fresh)) {
+        // writing now would throw away every game in it, keep ours for when it's fixed
+        cerr << "Not writing " << path << ", keeping " << unsavedGames << " games in memory" << endl;
+        return false;
+    }
+    mergeEntries(fresh, unsaved);
+    if (!writeFile(fresh)) {
+        cerr << "Failed to write " << path << endl;
+        return false;
+    }
+    entries = move(fresh);
+    unsaved.clear();
+    unsavedGames = 0;
+    loaded = true;
+    return true;
+}
+
+PlayerSummary PlayerStatsStore::summary(const string& playerName, const BoardConfig& config) {
+    if (!loaded) {
+        load();
+    }
+    PlayerSummary result = {};
+    auto player = entries.find({playerName, config});
+    if (player == entries.end()) {
+        return result;
+    }
+    Entry& entry = player->second;
+    entry.times.compress();
+    entry.bbbvPerSecond.compress();
+    result.games = entry.games;
+    result.wins = entry.wins;
+    if (entry.wins == 0) {
+        return result;
+    }
+
+    double median = entry.times.quantile(0.5);
+    result.medianMillis = static_cast<uint32_t>(lround(median));
+    result.p90Millis = static_cast<uint32_t>(lround(entry.times.quantile(0.9)));
+    result.medianBbbvPerSecond = entry.bbbvPerSecond.quantile(0.5);
+
+    auto everyone = entries.find({"", config});
+    if (everyone != entries.end()) {
+        everyone->second.times.compress();
+        result.fasterThan = 1 - everyone->second.times.cdf(median);
+    }
+    return result;
+}
@@ -0,0 +1,88 @@
+/*
+purpose: per-player statistics fed by every finished (non-practice) game: games played,
+wins, and the distribution of win times and 3BV/s for each board configuration
+(wins only come from verified submissions, see LeaderboardService.h)
+
+implementation:
+- each (player, config) keeps counters plus two t-digests (see TDigest.h), so memory per
+  player is bounded no matter how many games they play, and median / p90 queries read a
+  fixed number of centroids
+- a per-config entry (empty player name) holds every player's wins, "faster than X%"
+  is where the player's median falls in it; a game recorded with an empty name is dropped
+- lookups are a hash map find, no scan over players or games
+- player_stats.dat is a binary snapshot of all entries; games recorded since the last
+  flush are kept separately and flush() merges them into whatever is on disk now under
+  an exclusive lock (the sketches are mergeable), so several game processes can share
+  the file without losing each other's games
+- flush() never writes over a file it couldn't read (only a missing one counts as empty),
+  the unsaved games are kept for the next try instead
+- mirror() shows a win the daemon records in this process's summaries without ever
+  writing it, the daemon's own flush puts it in the file
+*/
+
+#ifndef PLAYERSTATSSTORE_H
+#define PLAYERSTATSSTORE_H
+
+#include "LeaderboardStore.h"
+#include "TDigest.h"
+#include <string>
+#include <unordered_map>
+#include <cstdint>
+using namespace std;
+
+// what the leaderboard shows for one player on one config
+struct PlayerSummary {
+    uint64_t games;
+    uint64_t wins;
+    uint32_t medianMillis;      // win times, 0 without wins
+    uint32_t p90Millis;
+    double medianBbbvPerSecond;
+    double fasterThan;          // share of everyone's wins on this config slower than the median (0..1)
+};
+
+class PlayerStatsStore {
+private:
+    struct Key {
+        string name; // empty = everyone on this config
+        BoardConfig config;
+        bool operator==(const Key& other) const;
+    };
+    struct KeyHash {
+        size_t operator()(const Key& key) const;
+    };
+    struct Entry {
+        uint64_t games = 0;
+        uint64_t wins = 0;
+        TDigest times;          // ms, wins only
+        TDigest bbbvPerSecond;  // wins only
+    };
+    typedef unordered_map<Key, Entry, KeyHash> EntryMap;
+
+    string path;
+    string lockPath;
+    EntryMap entries;  // the file as last read, plus our unsaved games
+    EntryMap unsaved;  // games recorded since the last flush
+    size_t unsavedGames;
+    bool loaded;
+
+    static void addGame(EntryMap& map, const Key& key, uint32_t timeMillis, double bbbvPerSecond, bool won);
+    static void mergeEntries(EntryMap& into, const EntryMap& from);
+    bool readFile(EntryMap& map) const;
+    bool writeFile(const EntryMap& map) const;
+
+public:
+    explicit PlayerStatsStore(const string& path = "player_stats.dat");
+
+    // read the shared file (done lazily by the first summary too)
+    bool load();
+    void record(const string& playerName, const BoardConfig& config, uint32_t timeMillis, double bbbvPerSecond, bool won);
+    // a win the daemon writes, only counted in memory (a later load / flush reads it from the file)
+    void mirror(const string& playerName, const BoardConfig& config, uint32_t timeMillis, double bbbvPerSecond);
+    // merge unsaved games into the file, also picks up everyone else's
+    bool flush();
+    size_t pendingGames() const { return unsavedGames; }
+
+    PlayerSummary summary(const string& playerName, const BoardConfig& config);
+};
+
+#endif
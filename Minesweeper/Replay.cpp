@@ -0,0 +1,301 @@
+/*
+key components:
+- varint encoding: packs small numbers into as few bytes as possible
+- recorder: encodes the header and moves into a memory buffer on the game thread
+- hand off: full (or finished) buffers are moved onto a queue under a short lock
+- writer thread: drains the queue and appends each chunk to its replay file
+- parsing: decodes a replay file back into its header and moves, refusing names the welcome screen wouldn't take
+*/
+
+#include "Replay.h"
+#include <fstream>
+#include <iostream>
+#include <chrono>
+#include <filesystem>
+#include <algorithm>
+
+// buffer size that triggers a hand off to the writer thread
+static const size_t CHUNK_SIZE = 4096;
+
+// "MSRP" + format version
+static const uint8_t REPLAY_MAGIC[5] = {'M', 'S', 'R', 'P', 1};
+
+void writeVarint(vector<uint8_t>& out, uint64_t value) {
+    while (value >= 0x80) {
+        out.push_back(static_cast<uint8_t>(value | 0x80));
+        value >>= 7;
+    }
+    out.push_back(static_cast<uint8_t>(value));
+}
+
+bool readVarint(const uint8_t*& pos, const uint8_t* end, uint64_t& value) {
+    value = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+        if (pos == end) return false;
+        uint8_t byte = *pos++;
+        value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+        if (!(byte & 0x80)) return true;
+    }
+    return false; // too many bytes, corrupt
+}
+
+bool isValidPlayerName(const string& name) {
+    if (name.empty() || name.size() > MAX_PLAYER_NAME) {
+        return false;
+    }
+    for (char c : name) {
+        if (!((c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z'))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool parseReplay(const uint8_t* data, size_t size, Replay& replay) {
+    const uint8_t* pos = data;
+    const uint8_t* end = data + size;
+
+    if (size < sizeof(REPLAY_MAGIC) || size > MAX_REPLAY_BYTES || !equal(REPLAY_MAGIC, REPLAY_MAGIC + sizeof(REPLAY_MAGIC), data)) {
+        return false;
+    }
+    pos += sizeof(REPLAY_MAGIC);
+
+    uint64_t seed, cols, rows, mines, nameLength;
+    if (!readVarint(pos, end, seed) || !readVarint(pos, end, cols) || !readVarint(pos, end, rows)
+        || !readVarint(pos, end, mines) || !readVarint(pos, end, nameLength)
+        || nameLength > static_cast<uint64_t>(end - pos)) {
+        return false;
+    }
+    if (cols > 0xffff || rows > 0xffff || mines > cols * rows) {
+        return false;
+    }
+
+    replay.header.seed = seed;
+    replay.header.colCount = static_cast<int>(cols);
+    replay.header.rowCount = static_cast<int>(rows);
+    replay.header.mineCount = static_cast<int>(mines);
+    replay.header.playerName.assign(reinterpret_cast<const char*>(pos), nameLength);
+    pos += nameLength;
+    if (!isValidPlayerName(replay.header.playerName)) {
+        return false;
+    }
+
+    replay.moves.clear();
+    uint64_t tick = 0;
+    int64_t cell = 0;
+    while (true) {
+        uint64_t tickDelta, packed;
+        if (!readVarint(pos, end, tickDelta) || !readVarint(pos, end, packed)) {
+            return false; // ran out before the end record (game still in progress or file cut off)
+        }
+        tick += tickDelta;
+        if (tick > UINT32_MAX) return false;
+
+        ReplayAction action = static_cast<ReplayAction>(packed & 3);
+        if (action == ReplayAction::End) {
+            if (pos == end || *pos > static_cast<uint8_t>(ReplayResult::Won)) return false;
+            replay.endTick = static_cast<uint32_t>(tick);
+            replay.result = static_cast<ReplayResult>(*pos);
+            return true;
+        }
+
+        uint64_t zigzag = packed >> 2;
+        cell += static_cast<int64_t>(zigzag >> 1) ^ -static_cast<int64_t>(zigzag & 1);
+        if (cell < 0 || cell >= static_cast<int64_t>(cols * rows)) return false;
+
+        replay.moves.push_back({static_cast<uint32_t>(tick), static_cast<uint32_t>(cell), action});
+    }
+}
+
+bool loadReplay(const string& path, Replay& replay) {
+    ifstream file(path, ios::binary | ios::ate);
+    if (!file.is_open()) {
+        return false;
+    }
+
+    streamoff size = file.tellg();
+    if (size < 0 || static_cast<uint64_t>(size) > MAX_REPLAY_BYTES) {
+        return false;
+    }
+    vector<uint8_t> bytes(static_cast<size_t>(size));
+    file.seekg(0);
+    file.read(reinterpret_cast<char*>(bytes.data()), bytes.size());
+    return file && parseReplay(bytes.data(), bytes.size(), replay);
+}
+
+ReplayRecorder::ReplayRecorder() : recording(false), lastTick(0), lastCell(0), moveCount(0), stopping(false) {
+    writer = thread(&ReplayRecorder::writerLoop, this);
+}
+
+ReplayRecorder::~ReplayRecorder() {
+    if (recording) {
+        finish(lastTick, ReplayResult::Abandoned);
+    }
+
+    {
+        lock_guard<mutex> lock(queueMutex);
+        stopping = true;
+    }
+    queueReady.notify_one();
+    writer.join(); // writer drains everything still queued before exiting
+}
+
+static string newReplayPath(const string& playerName, uint64_t seed) {
+    auto now = chrono::duration_cast<chrono::milliseconds>(chrono::system_clock::now().time_since_epoch()).count();
+    return "replays/" + to_string(now) + "_" + playerName + "_" + to_string(seed % 1000000) + ".msr";
+}
+
+void ReplayRecorder::begin(const ReplayHeader& header) {
+    if (recording) {
+        finish(lastTick, ReplayResult::Abandoned);
+    }
+
+    currentPath = newReplayPath(header.playerName, header.seed);
+    recording = true;
+    lastTick = 0;
+    lastCell = 0;
+    moveCount = 0;
+
+    gameBytes.clear();
+    buffer.assign(REPLAY_MAGIC, REPLAY_MAGIC + sizeof(REPLAY_MAGIC));
+    writeVarint(buffer, header.seed);
+    writeVarint(buffer, header.colCount);
+    writeVarint(buffer, header.rowCount);
+    writeVarint(buffer, header.mineCount);
+    writeVarint(buffer, header.playerName.size());
+    buffer.insert(buffer.end(), header.playerName.begin(), header.playerName.end());
+}
+
+void ReplayRecorder::resume(const ReplayHeader& header, const vector<uint8_t>& bytes, uint32_t lastTick, uint32_t lastCell, uint32_t moveCount) {
+    if (recording) {
+        finish(this->lastTick, ReplayResult::Abandoned);
+    }
+
+    // resumed games go to a fresh file that starts with everything recorded before the save
+    currentPath = newReplayPath(header.playerName, header.seed);
+    recording = true;
+    this->lastTick = lastTick;
+    this->lastCell = lastCell;
+    this->moveCount = moveCount;
+    gameBytes.clear();
+    buffer = bytes;
+}
+
+void ReplayRecorder::record(uint32_t tick, uint32_t cell, ReplayAction action) {
+    if (!recording) return;
+
+    // ticks only go forward, cells jump around so they get zigzag encoded (small +/- -> small number)
+    int64_t cellDelta = static_cast<int64_t>(cell) - static_cast<int64_t>(lastCell);
+    uint64_t zigzag = (static_cast<uint64_t>(cellDelta) << 1) ^ static_cast<uint64_t>(cellDelta >> 63);
+
+    writeVarint(buffer, tick - lastTick);
+    writeVarint(buffer, (zigzag << 2) | static_cast<uint8_t>(action));
+    lastTick = tick;
+    lastCell = cell;
+    moveCount++;
+
+    if (buffer.size() >= CHUNK_SIZE) {
+        handOff(false);
+    }
+}
+
+void ReplayRecorder::finish(uint32_t tick, ReplayResult result) {
+    if (!recording) return;
+
+    // a game left before the first click isnt worth a file
+    if (result == ReplayResult::Abandoned && moveCount == 0) {
+        recording = false;
+        buffer.clear();
+        return;
+    }
+
+    writeVarint(buffer, tick >= lastTick ? tick - lastTick : 0);
+    writeVarint(buffer, static_cast<uint8_t>(ReplayAction::End));
+    buffer.push_back(static_cast<uint8_t>(result));
+    lastTick = tick;
+    recording = false;
+
+    handOff(true);
+}
+
+bool ReplayRecorder::isRecording() const {
+    return recording;
+}
+
+const vector<uint8_t>& ReplayRecorder::lastGame() const {
+    return gameBytes;
+}
+
+vector<uint8_t> ReplayRecorder::gameSoFar() const {
+    vector<uint8_t> bytes = gameBytes;
+    bytes.insert(bytes.end(), buffer.begin(), buffer.end());
+    return bytes;
+}
+
+uint32_t ReplayRecorder::getLastTick() const {
+    return lastTick;
+}
+
+uint32_t ReplayRecorder::getLastCell() const {
+    return lastCell;
+}
+
+uint32_t ReplayRecorder::getMoveCount() const {
+    return moveCount;
+}
+
+// move the buffer onto the writer queue, the only time the game thread takes the lock
+void ReplayRecorder::handOff(bool last) {
+    gameBytes.insert(gameBytes.end(), buffer.begin(), buffer.end());
+
+    Chunk chunk;
+    chunk.path = currentPath;
+    chunk.bytes.swap(buffer);
+    chunk.last = last;
+    buffer.reserve(CHUNK_SIZE + 32);
+
+    {
+        lock_guard<mutex> lock(queueMutex);
+        queue.push_back(move(chunk));
+    }
+    queueReady.notify_one();
+}
+
+void ReplayRecorder::writerLoop() {
+    ofstream file;
+    string openPath;
+
+    error_code ec;
+    filesystem::create_directories("replays", ec);
+
+    while (true) {
+        Chunk chunk;
+        {
+            unique_lock<mutex> lock(queueMutex);
+            queueReady.wait(lock, [this] { return stopping || !queue.empty(); });
+            if (queue.empty()) {
+                break; // stopping and nothing left to write
+            }
+            chunk = move(queue.front());
+            queue.pop_front();
+        }
+
+        if (chunk.path != openPath) {
+            if (file.is_open()) file.close();
+            file.open(chunk.path, ios::binary | ios::app);
+            openPath = chunk.path;
+            if (!file.is_open()) {
+                cerr << "Failed to open replay file: " << chunk.path << endl;
+            }
+        }
+
+        if (file.is_open()) {
+            file.write(reinterpret_cast<const char*>(chunk.bytes.data()), chunk.bytes.size());
+        }
+
+        if (chunk.last) {
+            file.close();
+            openPath.clear();
+        }
+    }
+}
@@ -0,0 +1,131 @@
+/*
+purpose: records every game as a compact binary replay file
+
+implementation:
+- a replay is the board seed + dimensions (enough to regenerate the exact mines)
+  followed by every tile action the player made
+- each action is stored as (tick, cell index, action) with the tick and cell
+  delta-encoded against the previous move and written as varints, so a normal
+  move takes ~3-4 bytes
+- the game thread only appends bytes to an in-memory buffer, full buffers are
+  handed to a background writer thread so disk never stalls a frame
+- parseReplay / loadReplay decode a replay back into moves (used by the verifier),
+  anything over MAX_REPLAY_BYTES is refused before it's read
+- player names follow the welcome screen's rule (isValidPlayerName: 1-10 ascii letters),
+  a replay with any other name doesn't parse: names end up in file names, leaderboard
+  lines and stats keys, none of which can take a comma, a newline or an empty name
+
+file layout:
+    "MSRP" version
+    varint seed, varint cols, varint rows, varint mines, varint nameLength, name bytes
+    moves:  varint tickDelta, varint (zigzag(cellDelta) << 2 | action)
+    end:    varint tickDelta, varint (0 << 2 | End), result byte
+*/
+
+#ifndef REPLAY_H
+#define REPLAY_H
+
+#include <string>
+#include <vector>
+#include <deque>
+#include <cstdint>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+using namespace std;
+
+// no real game comes close: an expert game is a few hundred moves of 3-4 bytes, this is
+// ~250k moves, over an hour of clicking at the fastest pace the verifier accepts
+static const size_t MAX_REPLAY_BYTES = 1024 * 1024;
+static const size_t MAX_PLAYER_NAME = 10; // same limit as the welcome screen
+
+enum class ReplayAction : uint8_t {
+    Reveal = 0,
+    Flag = 1,
+    Chord = 2,
+    End = 3 // last record, followed by the result
+};
+
+enum class ReplayResult : uint8_t {
+    Abandoned = 0,
+    Lost = 1,
+    Won = 2
+};
+
+struct ReplayHeader {
+    uint64_t seed;
+    int colCount;
+    int rowCount;
+    int mineCount;
+    string playerName;
+};
+
+struct ReplayMove {
+    uint32_t tick; // game time in ms, pauses excluded
+    uint32_t cell; // row * colCount + col
+    ReplayAction action;
+};
+
+struct Replay {
+    ReplayHeader header;
+    vector<ReplayMove> moves;
+    uint32_t endTick;
+    ReplayResult result;
+};
+
+bool isValidPlayerName(const string& name);
+bool parseReplay(const uint8_t* data, size_t size, Replay& replay);
+bool loadReplay(const string& path, Replay& replay);
+
+// varint helpers (7 bits per byte, high bit = more bytes follow)
+void writeVarint(vector<uint8_t>& out, uint64_t value);
+bool readVarint(const uint8_t*& pos, const uint8_t* end, uint64_t& value);
+
+class ReplayRecorder {
+private:
+    // a finished block of bytes waiting for the writer thread
+    struct Chunk {
+        string path;
+        vector<uint8_t> bytes;
+        bool last;
+    };
+
+    // game thread state
+    string currentPath;
+    vector<uint8_t> buffer;
+    vector<uint8_t> gameBytes; // everything written for the current/last game, for verification
+    bool recording;
+    uint32_t lastTick;
+    uint32_t lastCell;
+    uint32_t moveCount;
+
+    // writer thread state
+    thread writer;
+    mutex queueMutex;
+    condition_variable queueReady;
+    deque<Chunk> queue;
+    bool stopping;
+
+    void handOff(bool last);
+    void writerLoop();
+
+public:
+    ReplayRecorder();
+    ~ReplayRecorder();
+
+    void begin(const ReplayHeader& header);
+    // carry on recording a saved game, bytes = everything recorded before it was saved
+    void resume(const ReplayHeader& header, const vector<uint8_t>& bytes, uint32_t lastTick, uint32_t lastCell, uint32_t moveCount);
+    void record(uint32_t tick, uint32_t cell, ReplayAction action);
+    void finish(uint32_t tick, ReplayResult result);
+    bool isRecording() const;
+    const vector<uint8_t>& lastGame() const;
+
+    // current game so far (for saving it), plus the delta-encoding state needed to resume it
+    vector<uint8_t> gameSoFar() const;
+    uint32_t getLastTick() const;
+    uint32_t getLastCell() const;
+    uint32_t getMoveCount() const;
+};
+
+#endif
@@ -0,0 +1,101 @@
+/*
+key components:
+- load: regenerates the board from the seed, runs every move once and stores keyframes
+- step: applies the next move
+- seek: restore nearest keyframe, then step forward (or just step if the target is close ahead)
+*/
+
+#include "ReplayPlayer.h"
+#include <algorithm>
+
+ReplayPlayer::ReplayPlayer() : board(nullptr), position(0) {}
+
+bool applyMove(Board& board, const ReplayMove& move) {
+    switch (move.action) {
+        case ReplayAction::Reveal: return board.reveal(move.cell);
+        case ReplayAction::Flag: return board.toggleFlag(move.cell);
+        case ReplayAction::Chord: return board.chord(move.cell);
+        default: return false;
+    }
+}
+
+void ReplayPlayer::load(const Replay& replay, Board& board) {
+    this->replay = replay;
+    this->board = &board;
+
+    const ReplayHeader& header = replay.header;
+    board.generate(header.colCount, header.rowCount, header.mineCount, header.seed);
+
+    // one pass through the whole game to build the keyframes
+    keyframes.clear();
+    keyframes.reserve(replay.moves.size() / KEYFRAME_INTERVAL + 1);
+    for (size_t i = 0; i < replay.moves.size(); ++i) {
+        if (i % KEYFRAME_INTERVAL == 0) {
+            keyframes.emplace_back();
+            board.saveSnapshot(keyframes.back());
+        }
+        applyMove(board, replay.moves[i]);
+    }
+    if (keyframes.empty()) {
+        keyframes.emplace_back();
+        board.saveSnapshot(keyframes.back());
+    }
+
+    // start at the beginning
+    board.loadSnapshot(keyframes[0]);
+    position = 0;
+}
+
+bool ReplayPlayer::step() {
+    if (atEnd()) {
+        return false;
+    }
+    applyMove(*board, replay.moves[position++]);
+    return true;
+}
+
+void ReplayPlayer::seekToMove(size_t move) {
+    move = min(move, replay.moves.size());
+
+    // close enough ahead -> just keep stepping, otherwise jump to the keyframe at or before the target
+    if (move < position || move - position > KEYFRAME_INTERVAL) {
+        size_t keyframe = min(move / KEYFRAME_INTERVAL, keyframes.size() - 1);
+        board->loadSnapshot(keyframes[keyframe]);
+        position = keyframe * KEYFRAME_INTERVAL;
+    }
+
+    while (position < move) {
+        applyMove(*board, replay.moves[position++]);
+    }
+}
+
+void ReplayPlayer::seekToTick(uint32_t tick) {
+    // first move that happens after tick
+    auto after = upper_bound(replay.moves.begin(), replay.moves.end(), tick,
+        [](uint32_t t, const ReplayMove& m) { return t < m.tick; });
+    seekToMove(after - replay.moves.begin());
+}
+
+size_t ReplayPlayer::getPosition() const {
+    return position;
+}
+
+size_t ReplayPlayer::getMoveCount() const {
+    return replay.moves.size();
+}
+
+bool ReplayPlayer::atEnd() const {
+    return position >= replay.moves.size();
+}
+
+uint32_t ReplayPlayer::nextTick() const {
+    return atEnd() ? replay.endTick : replay.moves[position].tick;
+}
+
+uint32_t ReplayPlayer::getEndTick() const {
+    return replay.endTick;
+}
+
+const Replay& ReplayPlayer::getReplay() const {
+    return replay;
+}
@@ -0,0 +1,54 @@
+/*
+purpose: steps through a recorded replay on a Board, with fast seeking
+
+implementation:
+- on load the whole replay is simulated once and a keyframe (board snapshot)
+  is kept every KEYFRAME_INTERVAL moves
+- playing forward applies one move at a time, so the UI can update just the changed tiles
+- seeking anywhere restores the closest keyframe at or before the target and
+  applies at most KEYFRAME_INTERVAL moves, instead of re-simulating from the start
+*/
+
+#ifndef REPLAYPLAYER_H
+#define REPLAYPLAYER_H
+
+#include "Board.h"
+#include "Replay.h"
+#include <vector>
+using namespace std;
+
+// apply one recorded move to a board, returns true if it changed the board
+bool applyMove(Board& board, const ReplayMove& move);
+
+class ReplayPlayer {
+public:
+    static const size_t KEYFRAME_INTERVAL = 64;
+
+private:
+    Board* board;
+    Replay replay;
+    vector<BoardSnapshot> keyframes; // keyframes[k] = board after k * KEYFRAME_INTERVAL moves
+    size_t position;                 // number of moves applied so far
+
+public:
+    ReplayPlayer();
+
+    void load(const Replay& replay, Board& board);
+
+    // apply the next move, board.getChanged() then has the tiles it touched
+    bool step();
+
+    // jump so that exactly `move` moves are applied (caller should redraw every tile after)
+    void seekToMove(size_t move);
+    // jump to the state at game time `tick` ms
+    void seekToTick(uint32_t tick);
+
+    size_t getPosition() const;
+    size_t getMoveCount() const;
+    bool atEnd() const;
+    uint32_t nextTick() const; // tick of the next move (endTick if none left)
+    uint32_t getEndTick() const;
+    const Replay& getReplay() const;
+};
+
+#endif
@@ -0,0 +1,123 @@
+/*
+key components:
+- verify: regenerates the board and steps through every move, counting clicks like the game does
+  and checking the gaps between moves, then the finish time against the 3BV
+- verifyFile: load + verify for one replay file
+- verifyFiles: simple thread pool, each worker grabs the next file index from an atomic counter
+*/
+
+#include "ReplayVerifier.h"
+#include "SessionTrace.h"
+#include "ReplayPlayer.h"
+#include <thread>
+#include <atomic>
+#include <algorithm>
+
+static VerifyResult rejected(const string& reason) {
+    VerifyResult result = {};
+    result.valid = false;
+    result.reason = reason;
+    return result;
+}
+
+VerifyResult ReplayVerifier::verify(const Replay& replay) {
+    SessionTrace::Scope trace("verify replay", "verify");
+    const ReplayHeader& header = replay.header;
+    // no bigger than a board the game can be set up with, so a few bytes of header can't make a
+    // verify worker allocate and generate hundreds of MB (every pool thread at once)
+    long long cellCount = static_cast<long long>(header.colCount) * header.rowCount;
+    if (header.colCount <= 0 || header.rowCount <= 0 || header.colCount > Board::MAX_SIDE || header.rowCount > Board::MAX_SIDE
+        || header.mineCount < 1 || header.mineCount >= cellCount) {
+        return rejected("bad board size");
+    }
+    if (!isValidPlayerName(header.playerName)) {
+        return rejected("bad player name");
+    }
+    if (replay.result != ReplayResult::Won) {
+        return rejected("game was not won");
+    }
+
+    board.generate(header.colCount, header.rowCount, header.mineCount, header.seed);
+
+    VerifyResult result = {};
+    result.playerName = header.playerName;
+    result.colCount = header.colCount;
+    result.rowCount = header.rowCount;
+    result.mineCount = header.mineCount;
+    result.bbbv = board.getBBBV();
+
+    for (size_t i = 0; i < replay.moves.size(); ++i) {
+        const ReplayMove& move = replay.moves[i];
+
+        if (board.isWon() || board.isLost()) {
+            return rejected("moves after the game ended");
+        }
+        if (i > 0) {
+            // left+right records the first button's click (a reveal or a flag) and then the chord on
+            // the same tile, those two can be back to back; anything else, a chord after a chord
+            // included, needs a real mouse movement
+            const ReplayMove& previous = replay.moves[i - 1];
+            if (move.tick < previous.tick) {
+                return rejected("moves too close together");
+            }
+            uint32_t gap = move.tick - previous.tick;
+            bool buttonPair = move.action == ReplayAction::Chord && move.cell == previous.cell
+                && (previous.action == ReplayAction::Reveal || previous.action == ReplayAction::Flag)
+                && gap <= BUTTON_PAIR_MILLIS;
+            if (!buttonPair && gap < MIN_MOVE_GAP_MILLIS) {
+                return rejected("moves too close together");
+            }
+        }
+
+        // same rule as the game: a click is useful if it changed the board
+        if (applyMove(board, move)) result.usefulClicks++;
+        else result.wastedClicks++;
+    }
+
+    if (!board.isWon()) {
+        return rejected(board.isLost() ? "hit a mine" : "board not cleared");
+    }
+    if (!replay.moves.empty() && replay.endTick < replay.moves.back().tick) {
+        return rejected("finish time before last move");
+    }
+    if (replay.endTick < static_cast<uint64_t>(result.bbbv) * MIN_MILLIS_PER_BBBV) {
+        return rejected("finished faster than humanly possible");
+    }
+
+    result.valid = true;
+    result.timeMillis = replay.endTick;
+    return result;
+}
+
+VerifyResult ReplayVerifier::verifyFile(const string& path) {
+    Replay replay;
+    if (!loadReplay(path, replay)) {
+        return rejected("unreadable replay");
+    }
+    return verify(replay);
+}
+
+vector<VerifyResult> ReplayVerifier::verifyFiles(const vector<string>& paths, int threadCount) {
+    vector<VerifyResult> results(paths.size());
+    atomic<size_t> next(0);
+
+    auto worker = [&]() {
+        ReplayVerifier verifier;
+        Replay replay;
+        for (size_t i = next++; i < paths.size(); i = next++) {
+            results[i] = loadReplay(paths[i], replay) ? verifier.verify(replay) : rejected("unreadable replay");
+        }
+    };
+
+    threadCount = max(1, min(threadCount, static_cast<int>(paths.size())));
+    vector<thread> pool;
+    for (int i = 1; i < threadCount; ++i) {
+        pool.emplace_back(worker);
+    }
+    worker(); // calling thread works too
+    for (auto& t : pool) {
+        t.join();
+    }
+
+    return results;
+}
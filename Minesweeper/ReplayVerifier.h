@@ -0,0 +1,61 @@
+/*
+purpose: checks that a recorded replay really is the win it claims to be before it reaches the leaderboard
+
+implementation:
+- rebuilds the board from the replay's seed with the headless Board engine
+- re-plays every move in order at full CPU speed (no window, no drawing)
+- rejects boards bigger than the game allows (Board::MAX_SIDE), so verifying stays cheap
+- rejects the replay if moves are out of range, happen after the game ended,
+  the board is not won on the last move, or the end time is before the last move
+- rejects player names the welcome screen wouldn't take (see isValidPlayerName in Replay.h)
+- rejects times no human could play: two clicks closer than MIN_MOVE_GAP_MILLIS, or a
+  finish faster than MIN_MILLIS_PER_BBBV per 3BV (25 3BV/s, well past the fastest recorded
+  games), so a forged replay with every move at tick 0 can't top the leaderboard; the only
+  exception is a left+right press, its reveal / flag and the chord on that tile can be
+  BUTTON_PAIR_MILLIS apart
+- the time, 3BV and click counts that go on the leaderboard come from this
+  re-simulation, never from what the client says
+- verifyFiles spreads a batch of replay files over a pool of threads
+*/
+
+#ifndef REPLAYVERIFIER_H
+#define REPLAYVERIFIER_H
+
+#include "Board.h"
+#include "Replay.h"
+#include <string>
+#include <vector>
+using namespace std;
+
+struct VerifyResult {
+    bool valid;
+    string reason; // why it was rejected (empty if valid)
+    string playerName;
+    int colCount;
+    int rowCount;
+    int mineCount;
+    uint32_t timeMillis;
+    int bbbv;
+    int usefulClicks;
+    int wastedClicks;
+};
+
+class ReplayVerifier {
+public:
+    static constexpr uint32_t MIN_MOVE_GAP_MILLIS = 15;
+    static constexpr uint32_t MIN_MILLIS_PER_BBBV = 40;
+    // the chord of a left+right press may follow its first button's reveal / flag this soon
+    static constexpr uint32_t BUTTON_PAIR_MILLIS = MIN_MOVE_GAP_MILLIS;
+
+private:
+    Board board; // reused between replays so a worker doesn't reallocate per game
+
+public:
+    VerifyResult verify(const Replay& replay);
+    VerifyResult verifyFile(const string& path);
+
+    // verify many files at once, results are in the same order as paths
+    static vector<VerifyResult> verifyFiles(const vector<string>& paths, int threadCount);
+};
+
+#endif
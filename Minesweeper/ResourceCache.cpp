@@ -0,0 +1,243 @@
+/*
+key components:
+- file tables: one path per id, in enum order (checked at compile time, and the pack has to list the same files)
+- lazy loading: a failed load is reported once and leaves an empty texture / font,
+  same as before when a missing image just drew nothing
+- preload: every font + texture in one go (the game scene calls it before its first frame)
+- background decoding: worker threads take the next image index from an atomic counter and
+  decode it into an sf::Image (no GL there), the UI thread uploads them with loadFromImage
+  from uploadReady / texture(); with the embedded pack there's nothing to decode, so it's off
+- clear: skips the images no worker has started, joins the workers, then resets every slot
+- embedded pack: when AssetPack.inc exists (generated by pack_assets) the assets come from it:
+  textures are created straight from raw RGBA, the font from memory, no file is opened
+*/
+
+#include "ResourceCache.h"
+#include "SessionTrace.h"
+#include <iostream>
+#include <algorithm>
+
+// one texture / font in the embedded pack (offsets into ASSET_PACK)
+struct PackedTexture {
+    uint32_t width;
+    uint32_t height;
+    uint32_t offset;
+};
+
+struct PackedFont {
+    uint32_t offset;
+    uint32_t size;
+};
+
+static constexpr const char* TEXTURE_FILES[] = {
+    "images/mine.png", "images/tile_hidden.png", "images/tile_revealed.png", "images/flag.png",
+    "images/number_1.png", "images/number_2.png", "images/number_3.png", "images/number_4.png",
+    "images/number_5.png", "images/number_6.png", "images/number_7.png", "images/number_8.png",
+    "images/face_happy.png", "images/face_win.png", "images/face_lose.png",
+    "images/debug.png", "images/pause.png", "images/play.png", "images/leaderboard.png",
+    "images/digits.png"
+};
+static_assert(sizeof(TEXTURE_FILES) / sizeof(TEXTURE_FILES[0]) == TEXTURE_COUNT, "one file per TextureId");
+
+static constexpr const char* FONT_FILES[] = {
+    "font.ttf"
+};
+static_assert(sizeof(FONT_FILES) / sizeof(FONT_FILES[0]) == FONT_COUNT, "one file per FontId");
+
+// pack_assets itself is built with MINESWEEPER_PACKING, so a stale pack can never stop the tool
+// that regenerates it from compiling
+#if !defined(MINESWEEPER_PACKING) && __has_include("AssetPack.inc")
+#include "AssetPack.inc"
+#define HAVE_ASSET_PACK 1
+
+// same files in the same order (the pack lists the file it took each entry from)
+template <size_t N, size_t M>
+static constexpr bool sameFiles(const char* const (&packed)[N], const char* const (&files)[M]) {
+    if (N != M) return false;
+    for (size_t i = 0; i < N; ++i) {
+        const char* a = packed[i];
+        const char* b = files[i];
+        while (*a && *a == *b) {
+            ++a;
+            ++b;
+        }
+        if (*a != *b) return false;
+    }
+    return true;
+}
+// a pack generated before an id was added, removed, reordered or pointed at another file would
+// hand out the wrong pixels
+static_assert(sameFiles(PACKED_TEXTURE_FILES, TEXTURE_FILES), "AssetPack.inc is stale (texture files changed), rerun pack_assets");
+static_assert(sameFiles(PACKED_FONT_FILES, FONT_FILES), "AssetPack.inc is stale (font files changed), rerun pack_assets");
+#else
+#define HAVE_ASSET_PACK 0
+#endif
+
+ResourceCache::ResourceCache() : preloaded(false), decoding(false), nextDecode(0) {
+    textureLoaded.fill(false);
+    fontLoaded.fill(false);
+    for (auto& done : decodeDone) {
+        done = false;
+    }
+}
+
+ResourceCache::~ResourceCache() {
+    for (auto& t : decoders) {
+        t.join();
+    }
+}
+
+ResourceCache& ResourceCache::get() {
+    static ResourceCache cache;
+    return cache;
+}
+
+const char* ResourceCache::path(TextureId id) {
+    return TEXTURE_FILES[static_cast<size_t>(id)];
+}
+
+const char* ResourceCache::path(FontId id) {
+    return FONT_FILES[static_cast<size_t>(id)];
+}
+
+bool ResourceCache::isEmbedded() {
+    return HAVE_ASSET_PACK;
+}
+
+void ResourceCache::startPreload() {
+    if (HAVE_ASSET_PACK || decoding || preloaded) {
+        return; // raw pixels are already in the binary
+    }
+    decoding = true;
+    unsigned threadCount = max(1u, min(thread::hardware_concurrency(), static_cast<unsigned>(TEXTURE_COUNT)));
+    for (unsigned i = 0; i < threadCount; ++i) {
+        decoders.emplace_back(&ResourceCache::decodeWorker, this);
+    }
+}
+
+void ResourceCache::decodeWorker() {
+    SessionTrace::nameThread("decode");
+    for (size_t i = nextDecode++; i < TEXTURE_COUNT; i = nextDecode++) {
+        SessionTrace::Scope trace("decode", SessionTrace::STARTUP, path(static_cast<TextureId>(i)));
+        if (!decoded[i].loadFromFile(path(static_cast<TextureId>(i)))) {
+            decoded[i] = sf::Image(); // upload reports it
+        }
+        {
+            lock_guard<mutex> lock(decodeMutex);
+            decodeDone[i] = true;
+        }
+        decodeReady.notify_all();
+    }
+}
+
+// UI thread: decoded pixels -> GPU, then the CPU copy is dropped
+void ResourceCache::uploadDecoded(size_t index) {
+    SessionTrace::Scope trace("upload", SessionTrace::STARTUP, path(static_cast<TextureId>(index)));
+    textureLoaded[index] = true;
+    if (decoded[index].getSize().x == 0 || !textures[index].loadFromImage(decoded[index])) {
+        cerr << "Failed to load texture: " << path(static_cast<TextureId>(index)) << endl;
+    }
+    decoded[index] = sf::Image();
+}
+
+// everything uploaded: the workers are done, join them
+void ResourceCache::finishDecoding() {
+    for (auto& t : decoders) {
+        t.join();
+    }
+    decoders.clear();
+    decoding = false;
+}
+
+void ResourceCache::uploadReady() {
+    if (!decoding) {
+        return;
+    }
+    bool all = true;
+    for (size_t i = 0; i < TEXTURE_COUNT; ++i) {
+        if (!textureLoaded[i]) {
+            if (decodeDone[i]) {
+                uploadDecoded(i);
+            } else {
+                all = false;
+            }
+        }
+    }
+    if (all) {
+        finishDecoding();
+    }
+}
+
+void ResourceCache::loadTexture(TextureId id) {
+    size_t index = static_cast<size_t>(id);
+    if (decoding) {
+        // a worker has it (or will soon), wait for just this one
+        SessionTrace::Scope waitTrace("wait for decode", SessionTrace::STARTUP, path(id));
+        unique_lock<mutex> lock(decodeMutex);
+        decodeReady.wait(lock, [this, index] { return decodeDone[index].load(); });
+        lock.unlock();
+        waitTrace.end();
+        uploadDecoded(index);
+        return;
+    }
+
+    SessionTrace::Scope trace("texture", SessionTrace::STARTUP, path(id));
+    textureLoaded[index] = true; // even if it fails, so a missing file isn't retried every frame
+#if HAVE_ASSET_PACK
+    const PackedTexture& packed = PACKED_TEXTURES[index];
+    if (textures[index].create(packed.width, packed.height)) {
+        textures[index].update(ASSET_PACK + packed.offset);
+        return;
+    }
+#endif
+    if (!textures[index].loadFromFile(path(id))) {
+        cerr << "Failed to load texture: " << path(id) << endl;
+    }
+}
+
+void ResourceCache::loadFont(FontId id) {
+    size_t index = static_cast<size_t>(id);
+    SessionTrace::Scope trace("font", SessionTrace::STARTUP, path(id));
+    fontLoaded[index] = true;
+#if HAVE_ASSET_PACK
+    // FreeType reads the pack in place, it's static so it outlives the font
+    const PackedFont& packed = PACKED_FONTS[index];
+    if (fonts[index].loadFromMemory(ASSET_PACK + packed.offset, packed.size)) {
+        return;
+    }
+#endif
+    if (!fonts[index].loadFromFile(path(id))) {
+        cerr << "Failed to load font: " << path(id) << endl;
+    }
+}
+
+void ResourceCache::clear() {
+    nextDecode = TEXTURE_COUNT; // workers stop after the image they're on
+    finishDecoding();
+    for (size_t i = 0; i < TEXTURE_COUNT; ++i) {
+        textures[i] = sf::Texture();
+        decoded[i] = sf::Image();
+        textureLoaded[i] = false;
+        decodeDone[i] = false;
+    }
+    for (size_t i = 0; i < FONT_COUNT; ++i) {
+        fonts[i] = sf::Font();
+        fontLoaded[i] = false;
+    }
+    nextDecode = 0;
+    preloaded = false;
+}
+
+void ResourceCache::preload() {
+    SessionTrace::Scope trace("preload", SessionTrace::STARTUP, isEmbedded() ? "embedded pack" : "image files");
+    for (size_t i = 0; i < FONT_COUNT; ++i) {
+        font(static_cast<FontId>(i));
+    }
+    for (size_t i = 0; i < TEXTURE_COUNT; ++i) {
+        texture(static_cast<TextureId>(i));
+    }
+    if (decoding) {
+        finishDecoding();
+    }
+    preloaded = true;
+}
@@ -0,0 +1,118 @@
+/*
+purpose: process-wide cache of the game's fonts and textures
+
+implementation:
+- every asset has a compile-time id (TextureId / FontId), the cache is a plain array
+  indexed by it, so a lookup is an array index, no string building or hashing
+- each asset is loaded (and uploaded to the GPU) once, on first use or by preload(),
+  and handed out by const reference, sprites share the one sf::Texture
+- the file for each id lives in one table in ResourceCache.cpp
+- one instance for the process (ResourceCache::get()), scenes come and go, the textures stay
+  until clear(): the SceneStack calls it when it closes its window, so no sf::Texture / sf::Font
+  is left for the static destructor to free after main (and SFML's own globals) is gone
+- if the game was built with the asset pack (AssetPack.inc from pack_assets.cpp) nothing
+  is read from disk: textures are uploaded from raw RGBA and the font parsed from memory
+- startPreload() (called first thing in main) decodes every image on worker threads while
+  the welcome screen waits for a name; uploadReady() runs once a frame on the UI thread and
+  uploads whatever is decoded, so by the time the game asks for a texture it's resident
+  (asking for one that's still decoding waits for just that one)
+- only decoding happens off the UI thread, textures are created and uploaded on it, the
+  public functions are for the UI thread only
+*/
+
+#ifndef RESOURCECACHE_H
+#define RESOURCECACHE_H
+
+#include <SFML/Graphics.hpp>
+#include <array>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+using namespace std;
+
+enum class TextureId : uint8_t {
+    Mine, TileHidden, TileRevealed, Flag,
+    Number1, Number2, Number3, Number4, Number5, Number6, Number7, Number8,
+    FaceHappy, FaceWin, FaceLose,
+    Debug, Pause, Play, Leaderboard,
+    Digits,
+    Count
+};
+
+enum class FontId : uint8_t {
+    Main,
+    Count
+};
+
+static const size_t TEXTURE_COUNT = static_cast<size_t>(TextureId::Count);
+static const size_t FONT_COUNT = static_cast<size_t>(FontId::Count);
+
+class ResourceCache {
+private:
+    array<sf::Texture, TEXTURE_COUNT> textures;
+    array<bool, TEXTURE_COUNT> textureLoaded;
+    array<sf::Font, FONT_COUNT> fonts;
+    array<bool, FONT_COUNT> fontLoaded;
+    bool preloaded;
+
+    // background decoding (startPreload)
+    array<sf::Image, TEXTURE_COUNT> decoded;
+    array<atomic<bool>, TEXTURE_COUNT> decodeDone;
+    bool decoding;              // workers started and not every texture uploaded yet
+    vector<thread> decoders;
+    atomic<size_t> nextDecode;
+    mutex decodeMutex;
+    condition_variable decodeReady;
+
+    ResourceCache();
+    ~ResourceCache();
+    void loadTexture(TextureId id);
+    void loadFont(FontId id);
+    void decodeWorker();
+    void uploadDecoded(size_t index);
+    void finishDecoding();
+
+public:
+    static ResourceCache& get();
+    ResourceCache(const ResourceCache&) = delete;
+    ResourceCache& operator=(const ResourceCache&) = delete;
+
+    const sf::Texture& texture(TextureId id) {
+        size_t index = static_cast<size_t>(id);
+        if (!textureLoaded[index]) loadTexture(id);
+        return textures[index];
+    }
+    const sf::Font& font(FontId id) {
+        size_t index = static_cast<size_t>(id);
+        if (!fontLoaded[index]) loadFont(id);
+        return fonts[index];
+    }
+
+    // texture for an adjacent mine count 1..8 (anything else is a plain revealed tile)
+    const sf::Texture& number(int count) {
+        if (count < 1 || count > 8) return texture(TextureId::TileRevealed);
+        return texture(static_cast<TextureId>(static_cast<int>(TextureId::Number1) + count - 1));
+    }
+
+    // start decoding every texture on worker threads, returns straight away
+    void startPreload();
+    // upload the textures the workers have finished, never waits (call once a frame)
+    void uploadReady();
+    // load everything now instead of on first use, waits for the workers if needed
+    // (reports how long it took the first time)
+    void preload();
+    // stop the decoders and free every texture + font (while the GL context is still up),
+    // anything asked for afterwards is loaded again
+    void clear();
+    // true if the assets are compiled in (see pack_assets.cpp)
+    static bool isEmbedded();
+
+    static const char* path(TextureId id);
+    static const char* path(FontId id);
+};
+
+#endif
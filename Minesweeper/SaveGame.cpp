@@ -0,0 +1,101 @@
+/*
+key components:
+- saveGame: header + raw tile bytes + replay bytes, written to <path>.tmp then renamed into place
+- loadGame: mmaps the file, checks the header (counters against the board size, offsets
+  without overflow) and sizes, then hands the mapping to the Board
+*/
+
+#include "SaveGame.h"
+#include <fstream>
+#include <cstring>
+#include <cstdio>
+
+static const char SAVE_MAGIC[4] = {'M', 'S', 'S', 'V'};
+static const uint32_t SAVE_VERSION = 1;
+
+bool saveGame(const string& path, const Board& board, const SavedGame& game) {
+    SaveHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, SAVE_MAGIC, sizeof(SAVE_MAGIC));
+    header.version = SAVE_VERSION;
+    header.colCount = board.getColCount();
+    header.rowCount = board.getRowCount();
+    header.mineCount = board.getMineCount();
+    header.revealedCount = board.getRevealedCount();
+    header.flagCount = board.getFlagCount();
+    header.bbbv = board.getBBBV();
+    header.seed = game.seed;
+    header.elapsedMillis = game.elapsedMillis;
+    header.lost = board.isLost();
+    strncpy(header.playerName, game.playerName.c_str(), sizeof(header.playerName) - 1);
+    header.cellOffset = sizeof(SaveHeader);
+    header.replayOffset = header.cellOffset + board.getCellCount();
+    header.replaySize = game.replayBytes.size();
+    header.replayLastTick = game.replayLastTick;
+    header.replayLastCell = game.replayLastCell;
+    header.replayMoveCount = game.replayMoveCount;
+
+    string tempPath = path + ".tmp";
+    ofstream file(tempPath, ios::binary | ios::trunc);
+    if (!file.is_open()) {
+        return false;
+    }
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.write(reinterpret_cast<const char*>(board.getCells()), board.getCellCount());
+    file.write(reinterpret_cast<const char*>(game.replayBytes.data()), game.replayBytes.size());
+    file.close();
+
+    if (!file || rename(tempPath.c_str(), path.c_str()) != 0) {
+        remove(tempPath.c_str());
+        return false;
+    }
+    return true;
+}
+
+bool loadGame(const string& path, Board& board, SavedGame& game) {
+    MappedFile file;
+    if (!file.open(path, true)) {
+        return false;
+    }
+
+    // header is read in place too, just validated before we trust any of it
+    if (file.getSize() < sizeof(SaveHeader)) {
+        return false;
+    }
+    const SaveHeader& header = *reinterpret_cast<const SaveHeader*>(file.getData());
+    uint64_t size = file.getSize();
+    if (memcmp(header.magic, SAVE_MAGIC, sizeof(SAVE_MAGIC)) != 0 || header.version != SAVE_VERSION
+        || header.colCount <= 0 || header.rowCount <= 0) {
+        return false;
+    }
+
+    // the counters drive isWon() and the mine counter, so they have to fit the board
+    int64_t cellCount = static_cast<int64_t>(header.colCount) * header.rowCount;
+    if (header.mineCount < 1 || header.mineCount >= cellCount
+        || header.revealedCount < 0 || header.revealedCount > cellCount - header.mineCount
+        || header.flagCount < 0 || header.flagCount > cellCount
+        || header.bbbv < 0 || header.bbbv > cellCount || header.lost > 1) {
+        return false;
+    }
+
+    // offsets are checked by subtracting from what's left so a huge value can't wrap around
+    if (header.cellOffset < sizeof(SaveHeader) || header.cellOffset > size
+        || header.replayOffset < header.cellOffset || header.replayOffset > size
+        || header.replayOffset - header.cellOffset < static_cast<uint64_t>(cellCount)
+        || header.replaySize > size - header.replayOffset) {
+        return false;
+    }
+
+    game.playerName.assign(header.playerName, strnlen(header.playerName, sizeof(header.playerName)));
+    game.seed = header.seed;
+    game.elapsedMillis = header.elapsedMillis;
+    game.replayLastTick = header.replayLastTick;
+    game.replayLastCell = header.replayLastCell;
+    game.replayMoveCount = header.replayMoveCount;
+    const uint8_t* replayStart = file.getData() + header.replayOffset;
+    game.replayBytes.assign(replayStart, replayStart + header.replaySize);
+
+    board.attachCells(move(file), header.cellOffset, header.colCount, header.rowCount, header.mineCount,
+                      header.revealedCount, header.flagCount, header.bbbv, header.lost != 0);
+    return true;
+}
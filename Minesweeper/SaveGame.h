@@ -0,0 +1,59 @@
+/*
+purpose: save an unfinished game to disk and resume it later
+
+implementation:
+- fixed binary layout that can be memory-mapped and used as-is:
+    SaveHeader (fixed size) | one byte per tile (Board's own cell format) | replay bytes so far
+- on resume the tile bytes are not parsed or copied, the Board points straight into the mapped file
+  (private mapping, so playing on never changes the save file)
+- the replay recorded so far is stored too, so a resumed game can still be verified for the leaderboard
+- writes go to a temp file first and are renamed over the old save, so a crash mid-save can't
+  leave a half written file behind
+*/
+
+#ifndef SAVEGAME_H
+#define SAVEGAME_H
+
+#include "Board.h"
+#include <string>
+#include <vector>
+#include <cstdint>
+using namespace std;
+
+struct SaveHeader {
+    char magic[4];          // "MSSV"
+    uint32_t version;
+    int32_t colCount;
+    int32_t rowCount;
+    int32_t mineCount;
+    int32_t revealedCount;
+    int32_t flagCount;
+    int32_t bbbv;
+    uint64_t seed;
+    uint32_t elapsedMillis;
+    uint32_t lost;
+    char playerName[16];    // nul padded
+    uint64_t cellOffset;
+    uint64_t replayOffset;
+    uint64_t replaySize;
+    uint32_t replayLastTick;
+    uint32_t replayLastCell;
+    uint32_t replayMoveCount;
+    uint32_t reserved;
+};
+
+// everything about a saved game that isn't the tiles themselves
+struct SavedGame {
+    string playerName;
+    uint64_t seed;
+    uint32_t elapsedMillis;
+    vector<uint8_t> replayBytes;
+    uint32_t replayLastTick;
+    uint32_t replayLastCell;
+    uint32_t replayMoveCount;
+};
+
+bool saveGame(const string& path, const Board& board, const SavedGame& game);
+bool loadGame(const string& path, Board& board, SavedGame& game);
+
+#endif
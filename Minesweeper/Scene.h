@@ -0,0 +1,43 @@
+/*
+purpose: one screen of the game (welcome, game, leaderboard) living on the SceneStack
+
+implementation:
+- scenes don't own a window, they all draw into the SceneStack's single window and use
+  its shared resources (font), so switching screens creates nothing
+- only the top scene gets events and update(); drawing starts from the highest scene
+  that isn't an overlay, so an overlay (the leaderboard) is drawn over what's under it
+- a scene changes screens through stack.push / pop / replace, which take effect once the
+  current event or frame is done (a scene may pop itself)
+- isIdle() = "this frame's update changed nothing", a scene that says so promises the
+  frame didn't touch the heap (checked in -DMINESWEEPER_ALLOC_CHECK builds, see
+  AllocationCounter.h)
+*/
+
+#ifndef SCENE_H
+#define SCENE_H
+
+#include <SFML/Graphics.hpp>
+using namespace std;
+
+class SceneStack;
+
+class Scene {
+protected:
+    SceneStack& stack;
+
+public:
+    explicit Scene(SceneStack& stack) : stack(stack) {}
+    virtual ~Scene() {}
+    Scene(const Scene&) = delete;
+    Scene& operator=(const Scene&) = delete;
+
+    virtual void handleEvent(const sf::Event& event) = 0;
+    virtual void update() {}                         // once a frame, top scene only
+    virtual void draw(sf::RenderWindow& window) = 0;
+    virtual bool isOverlay() const { return false; } // true = scenes below stay visible
+    virtual void onResume() {}                       // the scene above was popped
+    virtual void onExit() {}                         // the window is closing
+    virtual bool isIdle() const { return false; }    // after update(): nothing changed this frame
+};
+
+#endif
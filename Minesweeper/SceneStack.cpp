@@ -0,0 +1,162 @@
+/*
+key components:
+- constructor: creates the window, the shared font comes from the ResourceCache
+- applyPending: queued push / pop / replace, popping the top hands control back (onResume)
+- run: poll events -> top scene, top scene update, draw from the lowest visible scene up
+  (the profiler overlay last), events and display are timed as frame phases, and with
+  --trace every frame and its events / update / draw / display are SessionTrace scopes,
+  every display() is reported to SessionTrace::frameShown (the startup ends on the game's
+  first frame), the first one after a replace ends its "scene switch" startup span
+- exit: onExit on every scene (top first), then close(): they're destroyed top first, the
+  ResourceCache is cleared and the window closes (also at the end of run and in the destructor)
+*/
+
+#include "SceneStack.h"
+#include "SessionTrace.h"
+#include "AllocationCounter.h"
+#include <iostream>
+
+SceneStack::SceneStack(int width, int height, const string& title)
+    : font(ResourceCache::get().font(FontId::Main)), profiler(font), replaceShown(true) {
+    SessionTrace::Scope trace("window", SessionTrace::STARTUP);
+    window.create(sf::VideoMode(width, height), title, sf::Style::Close);
+}
+
+SceneStack::~SceneStack() {
+    close();
+}
+
+void SceneStack::push(unique_ptr<Scene> scene) {
+    pending.push_back({Change::Push, move(scene)});
+}
+
+void SceneStack::pop() {
+    pending.push_back({Change::Pop, nullptr});
+}
+
+void SceneStack::replace(unique_ptr<Scene> scene, chrono::steady_clock::time_point requestTime) {
+    replaceTime = requestTime;
+    replaceShown = false;
+    pending.push_back({Change::Replace, move(scene)});
+}
+
+bool SceneStack::applyPending() {
+    // a change can queue more changes (a scene's constructor / onResume), so take them one at a time
+    bool applied = !pending.empty();
+    while (!pending.empty()) {
+        PendingChange next = move(pending.front());
+        pending.erase(pending.begin());
+
+        if (next.change != Change::Push && !scenes.empty()) {
+            scenes.pop_back();
+        }
+        if (next.change == Change::Pop) {
+            if (!scenes.empty()) {
+                scenes.back()->onResume();
+            }
+        } else {
+            scenes.push_back(move(next.scene));
+        }
+    }
+    return applied;
+}
+
+void SceneStack::exit() {
+    for (auto it = scenes.rbegin(); it != scenes.rend(); ++it) {
+        (*it)->onExit();
+    }
+    close();
+}
+
+void SceneStack::close() {
+    clear(); // while the window (and its GL context) is still there
+    ResourceCache::get().clear();
+    window.close();
+}
+
+// a vector destroys front to back, which would free the game (and its LeaderboardService)
+// before the leaderboard overlay on top of it that still holds a reference
+void SceneStack::clear() {
+    pending.clear(); // queued scenes can point at the ones below too, they go first
+    while (!scenes.empty()) {
+        scenes.pop_back();
+    }
+}
+
+void SceneStack::run() {
+    applyPending();
+    bool quiet = false; // the first frame of a scene builds its text geometry / glyphs
+    uint64_t frameNumber = 0;
+
+    while (window.isOpen() && !scenes.empty()) {
+        uint64_t allocationsBefore = AllocationCounter::thisThread();
+        frameNumber++;
+        profiler.beginFrame();
+        SessionTrace::Scope frameTrace("frame", "frame");
+        sf::Event event;
+        FrameProfiler::Scope eventsPhase(profiler, FramePhase::Events);
+        SessionTrace::Scope eventsTrace("events", "frame");
+        while (window.isOpen() && window.pollEvent(event)) {
+            if (event.type == sf::Event::Closed) {
+                exit();
+                break;
+            }
+            scenes.back()->handleEvent(event);
+            applyPending();
+            quiet = false;
+            if (scenes.empty()) {
+                break;
+            }
+        }
+        eventsPhase.end();
+        eventsTrace.end();
+        if (!window.isOpen() || scenes.empty()) {
+            break;
+        }
+
+        SessionTrace::Scope updateTrace("update", "frame");
+        ResourceCache::get().uploadReady(); // textures decoded in the background since last frame
+        scenes.back()->update();
+        if (applyPending()) {
+            quiet = false;
+        }
+        updateTrace.end();
+        if (scenes.empty()) {
+            break;
+        }
+
+        // overlays show what's under them, so start at the highest scene that covers the window
+        size_t first = scenes.size() - 1;
+        while (first > 0 && scenes[first]->isOverlay()) {
+            first--;
+        }
+        SessionTrace::Scope drawTrace("draw", "frame");
+        for (size_t i = first; i < scenes.size(); ++i) {
+            scenes[i]->draw(window);
+        }
+        profiler.drawOverlay(window);
+        drawTrace.end();
+
+        // everything up to display(), which is the driver's
+        if (ALLOCATION_CHECK && quiet && !profiler.isEnabled() && scenes.back()->isIdle()) {
+            uint64_t allocations = AllocationCounter::thisThread() - allocationsBefore;
+            if (allocations > 0) {
+                cerr << "allocation check: quiet frame " << frameNumber << " made " << allocations << " heap allocation(s)" << endl;
+                abort();
+            }
+        }
+        quiet = true;
+        FrameProfiler::Scope displayPhase(profiler, FramePhase::Display);
+        SessionTrace::Scope displayTrace("display", "frame");
+        window.display();
+        displayPhase.end();
+        displayTrace.end();
+        if (!replaceShown) {
+            replaceShown = true;
+            SessionTrace::span("scene switch", SessionTrace::STARTUP, replaceTime); // before frameShown() can end the startup
+        }
+        SessionTrace::frameShown();
+    }
+
+    close();
+}
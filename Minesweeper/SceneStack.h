@@ -0,0 +1,79 @@
+/*
+purpose: the game's one window and the stack of scenes shown in it
+
+implementation:
+- the window (and its GL context) is created once and kept for the whole run, every
+  scene uses the same font (from the ResourceCache)
+- run() is the only main loop: events go to the top scene, then it updates, then every
+  visible scene draws bottom to top and the frame is displayed
+- push / pop / replace are queued and applied between events / frames, so a scene can
+  replace or pop itself from inside its own handleEvent
+- closing the window gives every scene (top first) an onExit(), the game saves there
+- scenes are destroyed top first (on exit and in the destructor), an overlay can use what
+  the scene under it owns (the leaderboard overlay uses the game's LeaderboardService)
+- the ResourceCache is cleared right after the scenes, before the window closes
+- every display is reported to SessionTrace::frameShown (the startup report, see
+  SessionTrace.h), and a replace (welcome -> game) adds a "scene switch" phase from the request (enter
+  pressed, before the game scene is even built) to the new scene's first frame
+- gives the ResourceCache a chance to upload finished background decodes every frame
+- in allocation check builds, aborts when a quiet frame (no events, no scene change, idle
+  top scene) allocated on the UI thread, see AllocationCounter.h
+- owns the FrameProfiler: marks each frame, times event handling and display, and draws
+  its overlay over every scene when it's on (the game scene has the toggle)
+*/
+
+#ifndef SCENESTACK_H
+#define SCENESTACK_H
+
+#include "Scene.h"
+#include "ResourceCache.h"
+#include "FrameProfiler.h"
+#include <SFML/Graphics.hpp>
+#include <memory>
+#include <vector>
+#include <string>
+#include <chrono>
+using namespace std;
+
+class SceneStack {
+private:
+    enum class Change { Push, Pop, Replace };
+    struct PendingChange {
+        Change change;
+        unique_ptr<Scene> scene;
+    };
+
+    sf::RenderWindow window;
+    const sf::Font& font;
+    FrameProfiler profiler;
+    vector<unique_ptr<Scene>> scenes;
+    vector<PendingChange> pending;
+    bool replaceShown;    // false from a replace until the next frame is displayed
+    chrono::steady_clock::time_point replaceTime;
+
+    bool applyPending(); // true if any change was applied
+    void exit();
+    void clear(); // destroy every scene, top first
+    void close(); // clear, free the cached textures + fonts, close the window
+
+public:
+    SceneStack(int width, int height, const string& title);
+    ~SceneStack();
+    SceneStack(const SceneStack&) = delete;
+    SceneStack& operator=(const SceneStack&) = delete;
+
+    sf::RenderWindow& getWindow() { return window; }
+    const sf::Font& getFont() const { return font; }
+    FrameProfiler& getProfiler() { return profiler; }
+
+    void push(unique_ptr<Scene> scene);
+    void pop();
+    // pop + push, e.g. welcome -> game; requestTime = when the switch was asked for (before
+    // the new scene was built), the trace's "scene switch" startup span starts there
+    void replace(unique_ptr<Scene> scene, chrono::steady_clock::time_point requestTime = chrono::steady_clock::now());
+    bool empty() const { return scenes.empty() && pending.empty(); }
+
+    void run();
+};
+
+#endif
@@ -0,0 +1,370 @@
+/*
+key components:
+- ThreadRing: fixed array of events, head (next slot the owning thread writes) and tail
+  (next slot the flusher reads) only ever grow, the slot is index % RING_EVENTS; the
+  owner publishes a slot with a release store of head, the flusher frees slots with a
+  release store of tail (single producer, single consumer)
+- registry: the rings live as long as the process (a thread's ring may still hold events
+  after the thread is gone), the mutex is only taken when a thread records its first event
+  and by the flusher to walk the list
+- flusher: wakes every FLUSH_MILLIS (or on stop), drains every ring into one string and
+  appends it to the file; stop() joins it, adds the thread name metadata and closes the JSON
+- startup report: while it's pending the flusher copies every STARTUP event it drains (by
+  name, a literal's address isn't the same in every translation unit); frameShown() marks the first
+  display, and after the game's first one asks the flusher for the report, which prints
+  after its next drain (or stops the trace, whose last drain prints it)
+*/
+
+#include "SessionTrace.h"
+#include <iostream>
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <chrono>
+#include <algorithm>
+#include <map>
+#include <cstdio>
+#include <cstring>
+#include <unistd.h>
+
+struct TraceEvent {
+    const char* name;
+    const char* category;
+    const char* detail;
+    const char* argName;
+    int64_t argValue;
+    int64_t startNanos;
+    int64_t durationNanos; // -1 for a mark
+};
+
+struct StartupEvent {
+    TraceEvent event;
+    int thread;
+};
+
+struct ThreadRing {
+    TraceEvent events[SessionTrace::RING_EVENTS];
+    atomic<size_t> head{0};
+    atomic<size_t> tail{0};
+    atomic<uint64_t> dropped{0};
+    atomic<const char*> threadName{nullptr};
+    int thread = 0;
+};
+
+atomic<bool> SessionTrace::enabled(false);
+
+static chrono::steady_clock::time_point origin;
+static mutex registryMutex;
+static vector<unique_ptr<ThreadRing>> rings;
+static thread_local ThreadRing* localRing = nullptr;
+
+static FILE* traceFile = nullptr;
+static thread flusher;
+static mutex flushMutex;
+static condition_variable flushWake;
+static bool stopping = false;
+static bool firstEvent = true;  // flusher only: no comma before the first event
+static string tracePath;
+
+// startup report
+static atomic<bool> startupPending(false); // asked for and not printed yet, the flusher collects meanwhile
+static atomic<bool> startupReportNow(false);
+static atomic<int> startupBudgetMillis(0);
+static bool startupStopAfter = false;      // ui thread only, like the two below
+static bool startupFinishPending = false;
+static bool startupFirstShown = false;
+static vector<StartupEvent> startupEvents; // flusher only
+
+static ThreadRing& threadRing() {
+    if (!localRing) {
+        auto ring = make_unique<ThreadRing>();
+        lock_guard<mutex> lock(registryMutex);
+        ring->thread = static_cast<int>(rings.size()) + 1;
+        localRing = ring.get();
+        rings.push_back(move(ring));
+    }
+    return *localRing;
+}
+
+int64_t SessionTrace::nowNanos() {
+    return chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - origin).count();
+}
+
+void SessionTrace::Scope::end() {
+    if (!running) {
+        return;
+    }
+    running = false;
+    if (!enabled.load(memory_order_relaxed)) {
+        return; // stopped while this scope was open
+    }
+    record(name, category, detail, argName, argValue, startNanos, nowNanos() - startNanos);
+}
+
+void SessionTrace::record(const char* name, const char* category, const char* detail, const char* argName, int64_t argValue,
+                          int64_t startNanos, int64_t durationNanos) {
+    ThreadRing& ring = threadRing();
+    size_t head = ring.head.load(memory_order_relaxed);
+    size_t used = head - ring.tail.load(memory_order_acquire);
+    if (used >= RING_EVENTS) {
+        ring.dropped.fetch_add(1, memory_order_relaxed); // flusher is behind, don't wait for it
+        return;
+    }
+    ring.events[head % RING_EVENTS] = {name, category, detail, argName, argValue, startNanos, durationNanos};
+    ring.head.store(head + 1, memory_order_release);
+    if (used == RING_EVENTS / 2) {
+        flushWake.notify_one(); // filling up faster than FLUSH_MILLIS, drain early
+    }
+}
+
+void SessionTrace::nameThread(const char* name) {
+    if (isEnabled()) {
+        threadRing().threadName.store(name, memory_order_relaxed);
+    }
+}
+
+void SessionTrace::mark(const char* name, const char* category) {
+    if (isEnabled()) {
+        record(name, category, nullptr, nullptr, 0, nowNanos(), -1);
+    }
+}
+
+void SessionTrace::span(const char* name, const char* category, chrono::steady_clock::time_point since) {
+    if (isEnabled()) {
+        int64_t startNanos = chrono::duration_cast<chrono::nanoseconds>(since - origin).count();
+        record(name, category, nullptr, nullptr, 0, startNanos, nowNanos() - startNanos);
+    }
+}
+
+static void appendJsonString(string& text, const char* value) {
+    text += '"';
+    for (const char* c = value; *c; ++c) {
+        if (*c == '"' || *c == '\\') {
+            text += '\\';
+        }
+        text += *c;
+    }
+    text += '"';
+}
+
+// flusher: everything published so far in every ring -> text
+static void drainRings(string& text) {
+    vector<ThreadRing*> current;
+    {
+        lock_guard<mutex> lock(registryMutex);
+        for (auto& ring : rings) {
+            current.push_back(ring.get());
+        }
+    }
+    int pid = static_cast<int>(getpid());
+    bool collectStartup = startupPending.load();
+    char line[320];
+    for (ThreadRing* ring : current) {
+        size_t head = ring->head.load(memory_order_acquire);
+        size_t tail = ring->tail.load(memory_order_relaxed);
+        for (; tail != head; ++tail) {
+            const TraceEvent& event = ring->events[tail % SessionTrace::RING_EVENTS];
+            snprintf(line, sizeof(line), "%s{\"name\":\"%s\",\"cat\":\"%s\",\"pid\":%d,\"tid\":%d,\"ts\":%.3f",
+                     firstEvent ? "" : ",\n", event.name, event.category, pid, ring->thread, event.startNanos / 1000.0);
+            text += line;
+            if (event.durationNanos < 0) {
+                text += ",\"ph\":\"i\",\"s\":\"p\"";
+            } else {
+                snprintf(line, sizeof(line), ",\"ph\":\"X\",\"dur\":%.3f", event.durationNanos / 1000.0);
+                text += line;
+            }
+            if (event.argName || event.detail) {
+                text += ",\"args\":{";
+                if (event.argName) {
+                    snprintf(line, sizeof(line), "\"%s\":%lld%s", event.argName, static_cast<long long>(event.argValue), event.detail ? "," : "");
+                    text += line;
+                }
+                if (event.detail) {
+                    text += "\"detail\":";
+                    appendJsonString(text, event.detail);
+                }
+                text += '}';
+            }
+            text += '}';
+            firstEvent = false;
+            if (collectStartup && strcmp(event.category, SessionTrace::STARTUP) == 0) {
+                startupEvents.push_back({event, ring->thread});
+            }
+        }
+        ring->tail.store(head, memory_order_release);
+    }
+}
+
+// flusher, once the game's first frame was shown: what the player waited on, phase by phase
+static void printStartupReport() {
+    stable_sort(startupEvents.begin(), startupEvents.end(), [](const StartupEvent& a, const StartupEvent& b) {
+        return a.event.startNanos < b.event.startNanos;
+    });
+
+    cout << "startup profile (ms from process start):" << endl;
+    map<string, pair<int64_t, int>> totals; // name -> total ns, count
+    int64_t firstDisplayNanos = -1;
+    char line[256];
+    for (const StartupEvent& startup : startupEvents) {
+        const TraceEvent& event = startup.event;
+        if (event.durationNanos < 0) {
+            snprintf(line, sizeof(line), "  %9.2f            [%d] %s", event.startNanos / 1e6, startup.thread, event.name);
+        } else {
+            snprintf(line, sizeof(line), "  %9.2f %9.2f  [%d] %s%s%s", event.startNanos / 1e6, event.durationNanos / 1e6,
+                     startup.thread, event.name, event.detail ? " " : "", event.detail ? event.detail : "");
+            auto& total = totals[event.name];
+            total.first += event.durationNanos;
+            total.second++;
+        }
+        if (firstDisplayNanos < 0 && strcmp(event.name, "first display") == 0) {
+            firstDisplayNanos = event.startNanos;
+        }
+        cout << line << endl;
+    }
+    cout << "  totals:" << endl;
+    for (const auto& total : totals) {
+        snprintf(line, sizeof(line), "  %9.2f ms  %s (x%d)", total.second.first / 1e6, total.first.c_str(), total.second.second);
+        cout << line << endl;
+    }
+
+    // the budget is for what the player waits on: the first frame (the welcome screen, or
+    // the replay), the game's phases after the name was typed are listed above
+    if (firstDisplayNanos >= 0) {
+        double firstDisplayMillis = firstDisplayNanos / 1e6;
+        int budget = startupBudgetMillis.load();
+        cout << "  first display after " << firstDisplayMillis << " ms";
+        if (budget > 0) {
+            cout << (firstDisplayMillis > budget ? ", OVER the " : ", within the ") << budget << " ms budget";
+        }
+        cout << endl;
+    }
+    cout << "  trace: " << tracePath << endl;
+
+    startupEvents.clear();
+    startupEvents.shrink_to_fit();
+    startupPending = false;
+}
+
+static void flushLoop() {
+    string text;
+    bool last = false;
+    while (!last) {
+        {
+            unique_lock<mutex> lock(flushMutex);
+            flushWake.wait_for(lock, chrono::milliseconds(SessionTrace::FLUSH_MILLIS), [] { return stopping; });
+            last = stopping;
+        }
+        drainRings(text);
+        if (!text.empty()) {
+            fwrite(text.data(), 1, text.size(), traceFile);
+            text.clear();
+        }
+        if (startupReportNow.exchange(false)) {
+            printStartupReport();
+        }
+    }
+}
+
+bool SessionTrace::start(const string& path, chrono::steady_clock::time_point startTime) {
+    if (isEnabled()) {
+        return true;
+    }
+    traceFile = fopen(path.c_str(), "w");
+    if (!traceFile) {
+        cerr << "Failed to open trace file: " << path << endl;
+        return false;
+    }
+    fputs("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n", traceFile);
+    origin = startTime;
+    tracePath = path;
+    {
+        lock_guard<mutex> lock(registryMutex);
+        for (auto& ring : rings) { // left over from an earlier session
+            ring->tail.store(ring->head.load());
+            ring->dropped = 0;
+        }
+    }
+    stopping = false;
+    firstEvent = true;
+    startupPending = false;
+    startupReportNow = false;
+    startupEvents.clear();
+    enabled = true;
+    flusher = thread(flushLoop);
+    return true;
+}
+
+void SessionTrace::stop() {
+    if (!isEnabled()) {
+        return;
+    }
+    enabled = false;
+    startupFinishPending = false;
+    {
+        lock_guard<mutex> lock(flushMutex);
+        stopping = true;
+    }
+    flushWake.notify_one();
+    flusher.join();
+
+    uint64_t dropped = 0;
+    int pid = static_cast<int>(getpid());
+    lock_guard<mutex> lock(registryMutex);
+    for (auto& ring : rings) {
+        dropped += ring->dropped;
+        const char* name = ring->threadName.load();
+        fprintf(traceFile, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":%d,\"tid\":%d,\"args\":{\"name\":\"%s %d\"}}",
+                firstEvent ? "" : ",\n", pid, ring->thread, name ? name : "thread", ring->thread);
+        firstEvent = false;
+    }
+    fputs("\n]}\n", traceFile);
+    if (fclose(traceFile) != 0) {
+        cerr << "Failed to write the trace file" << endl;
+    }
+    traceFile = nullptr;
+    if (dropped > 0) {
+        cerr << "trace: " << dropped << " events dropped (the flusher fell behind)" << endl;
+    }
+}
+
+void SessionTrace::reportStartup(bool stopAfter) {
+    if (!isEnabled()) {
+        return;
+    }
+    startupStopAfter = stopAfter;
+    startupFinishPending = false;
+    startupFirstShown = false;
+    startupPending = true;
+}
+
+void SessionTrace::setStartupBudget(int budgetMillis) {
+    startupBudgetMillis = budgetMillis;
+}
+
+void SessionTrace::finishStartupOnNextFrame() {
+    if (startupPending.load()) {
+        startupFinishPending = true;
+    }
+}
+
+void SessionTrace::frameShown() {
+    if (!startupPending.load(memory_order_relaxed)) {
+        return;
+    }
+    if (!startupFirstShown) {
+        startupFirstShown = true;
+        mark("first display", STARTUP);
+    }
+    if (startupFinishPending) {
+        startupFinishPending = false;
+        mark("game first display", STARTUP);
+        startupReportNow = true;
+        if (startupStopAfter) {
+            stop(); // its last drain prints the report
+        } else {
+            flushWake.notify_one();
+        }
+    }
+}
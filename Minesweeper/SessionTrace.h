@@ -0,0 +1,103 @@
+/*
+purpose: optional whole-session tracing ("project3 --trace session.json"): frames, reveals,
+flood fills, board generation, leaderboard / stats / journal i/o and replay verification
+are recorded as scoped events and written as Chrome trace JSON, so a session can be
+loaded into chrome://tracing or Perfetto to see where the time goes on every thread;
+the game's startup (config, window, font, every texture, the game scene) is one category
+of it (STARTUP), so the same trace shows startup and everything after
+
+implementation:
+- a Scope records its start on construction and its duration when it ends, and is
+  written as one complete ("X") event, so a begin can't lose its end when events are
+  dropped; setArg attaches one number (the cell, the tiles a flood opened...), a detail
+  string (e.g. the texture's file) can be given up front
+- mark() records an instant ("i" event, first display), span() a phase that started
+  earlier than anything could hold a Scope for it (a scene switch, from the key press)
+- every thread records into its own fixed ring (RING_EVENTS events), registered the first
+  time the thread traces; only that thread writes to it and only the flusher reads it,
+  so recording is a couple of atomic loads / stores, no lock and no allocation
+- a flusher thread drains all rings every FLUSH_MILLIS, formats the JSON and appends it to
+  the file, so the file i/o never happens on the recording threads
+- a ring that's half full wakes the flusher early; a full one (the flusher fell behind)
+  drops the new event and counts it, stop() reports how many were lost
+- startup report (main's --profile-startup, see main.cpp): the flusher also keeps the
+  STARTUP events, and once the game scene has called finishStartupOnNextFrame() and the
+  SceneStack reports the next frameShown(), it prints them (start order, then the total per
+  name, then the first display against the budget); without --trace main traces to
+  startup_trace.json just for this and the trace stops right after the report
+- not started (the default) a Scope is one relaxed atomic load
+- names, categories, details and arg names must be string literals / static strings,
+  only the pointers are kept
+*/
+
+#ifndef SESSIONTRACE_H
+#define SESSIONTRACE_H
+
+#include <atomic>
+#include <string>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+using namespace std;
+
+class SessionTrace {
+public:
+    static constexpr size_t RING_EVENTS = 8192;  // per thread
+    static constexpr int FLUSH_MILLIS = 20;
+    static constexpr const char* STARTUP = "startup"; // category of the startup phases
+
+    class Scope {
+    private:
+        const char* name;
+        const char* category;
+        const char* detail;
+        const char* argName;
+        int64_t argValue;
+        int64_t startNanos;
+        bool running;
+
+    public:
+        Scope(const char* name, const char* category, const char* detail = nullptr)
+            : name(name), category(category), detail(detail), argName(nullptr), argValue(0), startNanos(0),
+              running(enabled.load(memory_order_relaxed)) {
+            if (running) {
+                startNanos = nowNanos();
+            }
+        }
+        ~Scope() { end(); }
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+        void setArg(const char* name, int64_t value) {
+            argName = name;
+            argValue = value;
+        }
+        void end();
+    };
+
+    // opens the file and starts the flusher, false if the file can't be written;
+    // timestamps count from origin (main passes its own start)
+    static bool start(const string& path, chrono::steady_clock::time_point origin = chrono::steady_clock::now());
+    // final drain, closes the JSON (call once the other threads are done)
+    static void stop();
+    static bool isEnabled() { return enabled.load(memory_order_relaxed); }
+    // label for the calling thread's row in the viewer
+    static void nameThread(const char* name);
+
+    static void mark(const char* name, const char* category);
+    static void span(const char* name, const char* category, chrono::steady_clock::time_point since); // since .. now
+
+    // startup report, see above (stopAfter = the trace was only started for it)
+    static void reportStartup(bool stopAfter);
+    static void setStartupBudget(int budgetMillis); // 0 = no budget
+    static void finishStartupOnNextFrame();
+    static void frameShown(); // SceneStack, after every display()
+
+private:
+    static atomic<bool> enabled;
+    static int64_t nowNanos();
+    static void record(const char* name, const char* category, const char* detail, const char* argName, int64_t argValue,
+                       int64_t startNanos, int64_t durationNanos);
+};
+
+#endif
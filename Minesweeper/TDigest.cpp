@@ -0,0 +1,154 @@
+/*
+key components:
+- add / merge: append to the buffer, merge once it's full
+- compress: one sorted pass, a centroid absorbs its neighbours while its k-size stays under 1
+- quantile / cdf: linear interpolation between centroid centres, min / max pin the ends
+*/
+
+#include "TDigest.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+static const double PI = 3.14159265358979323846;
+
+// the scale function and its inverse
+static double scaleK(double q, double compression) {
+    return compression / (2 * PI) * asin(2 * q - 1);
+}
+
+static double scaleQ(double k, double compression) {
+    if (k >= compression / 4) return 1;
+    return (sin(k * 2 * PI / compression) + 1) / 2;
+}
+
+TDigest::TDigest(double compression)
+    : compression(compression), totalWeight(0),
+      minValue(numeric_limits<double>::infinity()), maxValue(-numeric_limits<double>::infinity()) {}
+
+void TDigest::add(double value, double weight) {
+    if (weight <= 0 || std::isnan(value)) {
+        return;
+    }
+    buffer.push_back({value, weight});
+    totalWeight += weight;
+    minValue = min(minValue, value);
+    maxValue = max(maxValue, value);
+    if (buffer.size() >= static_cast<size_t>(BUFFER_FACTOR * compression)) {
+        compress();
+    }
+}
+
+void TDigest::merge(const TDigest& other) {
+    if (other.empty()) {
+        return;
+    }
+    buffer.insert(buffer.end(), other.centroids.begin(), other.centroids.end());
+    buffer.insert(buffer.end(), other.buffer.begin(), other.buffer.end());
+    totalWeight += other.totalWeight;
+    minValue = min(minValue, other.minValue);
+    maxValue = max(maxValue, other.maxValue);
+    compress();
+}
+
+void TDigest::compress() {
+    if (buffer.empty()) {
+        return;
+    }
+    buffer.insert(buffer.end(), centroids.begin(), centroids.end());
+    sort(buffer.begin(), buffer.end(), [](const Centroid& a, const Centroid& b) { return a.mean < b.mean; });
+    centroids.clear();
+
+    // merged centroids may span at most 1 in k, so the weight limit moves with the position
+    double weightSoFar = 0;
+    double weightLimit = totalWeight * scaleQ(scaleK(0, compression) + 1, compression);
+    Centroid current = buffer[0];
+    for (size_t i = 1; i < buffer.size(); ++i) {
+        const Centroid& next = buffer[i];
+        if (weightSoFar + current.weight + next.weight <= weightLimit) {
+            current.mean += (next.mean - current.mean) * next.weight / (current.weight + next.weight);
+            current.weight += next.weight;
+        } else {
+            weightSoFar += current.weight;
+            centroids.push_back(current);
+            weightLimit = totalWeight * scaleQ(scaleK(weightSoFar / totalWeight, compression) + 1, compression);
+            current = next;
+        }
+    }
+    centroids.push_back(current);
+    buffer.clear();
+}
+
+double TDigest::quantile(double q) const {
+    if (centroids.empty()) {
+        return 0;
+    }
+    if (centroids.size() == 1) {
+        return centroids[0].mean;
+    }
+    q = min(1.0, max(0.0, q));
+    double target = q * totalWeight;
+
+    // before the first centroid's centre: between min and its mean
+    double first = centroids[0].weight / 2;
+    if (target < first) {
+        return minValue + (centroids[0].mean - minValue) * target / first;
+    }
+
+    double centre = first;
+    for (size_t i = 0; i + 1 < centroids.size(); ++i) {
+        double nextCentre = centre + centroids[i].weight / 2 + centroids[i + 1].weight / 2;
+        if (target < nextCentre) {
+            double t = (target - centre) / (nextCentre - centre);
+            return centroids[i].mean + (centroids[i + 1].mean - centroids[i].mean) * t;
+        }
+        centre = nextCentre;
+    }
+
+    // past the last centre: between its mean and max
+    const Centroid& last = centroids.back();
+    double rest = totalWeight - centre;
+    return rest > 0 ? last.mean + (maxValue - last.mean) * (target - centre) / rest : maxValue;
+}
+
+double TDigest::cdf(double value) const {
+    if (centroids.empty() || value < minValue) {
+        return 0;
+    }
+    if (value >= maxValue) {
+        return 1;
+    }
+
+    double first = centroids[0].weight / 2;
+    if (value < centroids[0].mean) {
+        double span = centroids[0].mean - minValue;
+        return (span > 0 ? first * (value - minValue) / span : 0) / totalWeight;
+    }
+
+    double centre = first;
+    for (size_t i = 0; i + 1 < centroids.size(); ++i) {
+        double nextCentre = centre + centroids[i].weight / 2 + centroids[i + 1].weight / 2;
+        if (value < centroids[i + 1].mean) {
+            double span = centroids[i + 1].mean - centroids[i].mean;
+            double t = span > 0 ? (value - centroids[i].mean) / span : 0;
+            return (centre + (nextCentre - centre) * t) / totalWeight;
+        }
+        centre = nextCentre;
+    }
+
+    const Centroid& last = centroids.back();
+    double span = maxValue - last.mean;
+    double t = span > 0 ? (value - last.mean) / span : 1;
+    return (centre + (totalWeight - centre) * t) / totalWeight;
+}
+
+TDigest TDigest::fromCentroids(double compression, const vector<Centroid>& centroids, double minValue, double maxValue) {
+    TDigest digest(compression);
+    digest.centroids = centroids;
+    for (const Centroid& centroid : centroids) {
+        digest.totalWeight += centroid.weight;
+    }
+    digest.minValue = minValue;
+    digest.maxValue = maxValue;
+    return digest;
+}
@@ -0,0 +1,64 @@
+/*
+purpose: t-digest, a small mergeable sketch of a distribution for quantile / rank queries
+
+implementation:
+- the data is summarized as centroids (mean, weight), sorted by mean; the scale function
+  k(q) = compression / (2 pi) * asin(2q - 1) keeps centroids tiny near the tails and
+  bigger in the middle, so p90 / p99 stay accurate with few centroids
+- new values go into a buffer first, once it holds BUFFER_FACTOR * compression values it is
+  sorted together with the centroids and merged in one pass
+- the number of centroids never goes past about compression, however many values were
+  added: memory and query time don't grow with the data
+- two digests merge by feeding one's centroids into the other's buffer, so sketches
+  from different processes (or saved ones) can be combined without the original values
+*/
+
+#ifndef TDIGEST_H
+#define TDIGEST_H
+
+#include <vector>
+using namespace std;
+
+struct Centroid {
+    double mean;
+    double weight;
+};
+
+class TDigest {
+public:
+    static constexpr double DEFAULT_COMPRESSION = 100;
+    static const int BUFFER_FACTOR = 5;
+
+private:
+    double compression;
+    vector<Centroid> centroids; // merged, sorted by mean
+    vector<Centroid> buffer;    // added since the last merge, unsorted
+    double totalWeight;         // centroids + buffer
+    double minValue;
+    double maxValue;
+
+public:
+    explicit TDigest(double compression = DEFAULT_COMPRESSION);
+
+    void add(double value, double weight = 1);
+    void merge(const TDigest& other);
+    // fold the buffer into the centroids (queries expect this to have been done)
+    void compress();
+
+    // value at quantile q (0..1), 0 if empty
+    double quantile(double q) const;
+    // share of the weight at or below value (0..1)
+    double cdf(double value) const;
+
+    double count() const { return totalWeight; }
+    bool empty() const { return totalWeight <= 0; }
+    double getCompression() const { return compression; }
+    double getMin() const { return minValue; }
+    double getMax() const { return maxValue; }
+    const vector<Centroid>& getCentroids() const { return centroids; } // after compress()
+
+    // rebuild a saved digest from its compressed centroids
+    static TDigest fromCentroids(double compression, const vector<Centroid>& centroids, double minValue, double maxValue);
+};
+
+#endif
@@ -105,28 +105,28 @@ void Tile::setNumberSprite(const sf::Texture& texture, int number) {
     numberSprite.setTexture(texture);
 }
 
-void Tile::draw(sf::RenderWindow& window, bool debugMode) {
+void Tile::draw(sf::RenderWindow& window, FrameProfiler& profiler, bool debugMode) {
     if (isRevealed) {
-        window.draw(revealedSprite);
+        profiler.draw(window, revealedSprite);
 
         if (isMine) {
-            window.draw(mineSprite);
+            profiler.draw(window, mineSprite);
         } else if (adjacentMines > 0) {
-            window.draw(numberSprite);
+            profiler.draw(window, numberSprite);
         }
     } else {
-        window.draw(hiddenSprite);
+        profiler.draw(window, hiddenSprite);
 
         if (isFlagged) {
-            window.draw(flagSprite);
+            profiler.draw(window, flagSprite);
         }
 
         if (debugMode && isMine) {
-            window.draw(mineSprite);
+            profiler.draw(window, mineSprite);
         }
     }
 }
 
-void Tile::drawRevealed(sf::RenderWindow& window) {
-    window.draw(revealedSprite);
+void Tile::drawRevealed(sf::RenderWindow& window, FrameProfiler& profiler) {
+    profiler.draw(window, revealedSprite);
 }
\ No newline at end of file
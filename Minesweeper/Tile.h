@@ -13,6 +13,7 @@ implementation:
 #ifndef TILE_H
 #define TILE_H
 
+#include "FrameProfiler.h"
 #include <SFML/Graphics.hpp>
 #include <vector>
 using namespace std;
@@ -60,8 +61,9 @@ public:
     void setFlagSprite(const sf::Texture& texture);
     void setNumberSprite(const sf::Texture& texture, int number);
 
-    void draw(sf::RenderWindow& window, bool debugMode);
-    void drawRevealed(sf::RenderWindow& window);
+    // drawn through the profiler, which counts the sprites
+    void draw(sf::RenderWindow& window, FrameProfiler& profiler, bool debugMode);
+    void drawRevealed(sf::RenderWindow& window, FrameProfiler& profiler);
 };
 
 
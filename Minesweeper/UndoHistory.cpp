@@ -0,0 +1,85 @@
+/*
+key components:
+- record: sorts the changed tiles and packs them into (gap, length - 1) varint runs
+- decode: unpacks one entry's runs back into a tile list
+- undo / redo: decode the entry and let the board flip the bit on those tiles
+*/
+
+#include "UndoHistory.h"
+#include "Replay.h"
+#include <algorithm>
+
+UndoHistory::UndoHistory() : position(0) {}
+
+void UndoHistory::clear() {
+    bytes.clear();
+    entries.clear();
+    position = 0;
+}
+
+void UndoHistory::record(const Board& board, uint8_t bit) {
+    CellList changed = board.getChanged();
+    if (changed.empty()) return;
+
+    // a new action makes the undone ones unreachable
+    if (position < entries.size()) {
+        bytes.resize(entries[position].offset);
+        entries.resize(position);
+    }
+
+    // flood fill order jumps around, sorted tiles collapse into runs
+    scratch.assign(changed.begin(), changed.end());
+    sort(scratch.begin(), scratch.end());
+
+    Entry entry = {bytes.size(), 0, bit};
+    int previousEnd = 0;
+    size_t i = 0;
+    while (i < scratch.size()) {
+        size_t runEnd = i + 1;
+        while (runEnd < scratch.size() && scratch[runEnd] == scratch[runEnd - 1] + 1) {
+            runEnd++;
+        }
+        writeVarint(bytes, scratch[i] - previousEnd);
+        writeVarint(bytes, runEnd - i - 1);
+        previousEnd = scratch[runEnd - 1] + 1;
+        entry.runs++;
+        i = runEnd;
+    }
+
+    entries.push_back(entry);
+    position = entries.size();
+}
+
+void UndoHistory::decode(const Entry& entry) {
+    scratch.clear();
+    const uint8_t* data = bytes.data() + entry.offset;
+    const uint8_t* end = bytes.data() + bytes.size();
+    uint64_t cell = 0;
+    for (uint32_t run = 0; run < entry.runs; ++run) {
+        uint64_t gap, length;
+        readVarint(data, end, gap);
+        readVarint(data, end, length);
+        cell += gap;
+        for (uint64_t k = 0; k <= length; ++k) {
+            scratch.push_back(static_cast<int>(cell++));
+        }
+    }
+}
+
+bool UndoHistory::undo(Board& board) {
+    if (!canUndo()) return false;
+
+    position--;
+    decode(entries[position]);
+    board.toggleCells(scratch, entries[position].bit);
+    return true;
+}
+
+bool UndoHistory::redo(Board& board) {
+    if (!canRedo()) return false;
+
+    decode(entries[position]);
+    board.toggleCells(scratch, entries[position].bit);
+    position++;
+    return true;
+}
@@ -0,0 +1,55 @@
+/*
+purpose: undo / redo for practice mode, storing only what each action changed
+
+implementation:
+- every action (reveal, flag, chord) only ever flips one bit (revealed or flagged) on the
+  tiles it touched, so undoing it = flipping that bit back on the same tiles, and redo
+  flips it again -> an entry just needs the bit and the list of tiles
+- the tile list is sorted and stored as runs (gap from the last run, run length) of
+  varints in one shared byte buffer; a flood reveal is mostly long horizontal runs so it
+  costs a couple of bytes per row of the opening, a flag is ~2 bytes
+- history is linear with a cursor: undo moves it back, redo forward, a new action
+  after an undo drops everything past the cursor
+- undo/redo cost is proportional to the number of tiles the action changed, never the board
+*/
+
+#ifndef UNDOHISTORY_H
+#define UNDOHISTORY_H
+
+#include "Board.h"
+#include <vector>
+#include <cstdint>
+using namespace std;
+
+class UndoHistory {
+private:
+    struct Entry {
+        size_t offset;   // where its runs start in bytes
+        uint32_t runs;   // number of runs
+        uint8_t bit;     // Board::REVEALED_BIT or Board::FLAGGED_BIT
+    };
+
+    vector<uint8_t> bytes;  // every entry's runs back to back
+    vector<Entry> entries;
+    size_t position;        // entries before this are applied, the rest can be redone
+    vector<int> scratch;    // reused for sorting / decoding tile lists
+
+    void decode(const Entry& entry);
+
+public:
+    UndoHistory();
+
+    void clear();
+    // store what the board's last action changed (call right after the action)
+    void record(const Board& board, uint8_t bit);
+
+    // flip the last applied / next undone action, board.getChanged() then has the tiles
+    bool undo(Board& board);
+    bool redo(Board& board);
+
+    bool canUndo() const { return position > 0; }
+    bool canRedo() const { return position < entries.size(); }
+    size_t getByteCount() const { return bytes.size(); }
+};
+
+#endif
@@ -0,0 +1,111 @@
+/*
+key components:
+- constructor: sets up welcome screen text elements with the stack's shared font 
+- text management: centers text for display, the name line is only rebuilt when the name
+  changes (nothing is built per frame)
+- input handling:
+    - accept only alphabetical letters
+    - enforce 10 character limit
+    - formats name with first letter capitalized, rest lowercase
+    - processes backspace to delete character
+- event processing: handles key / text events (closing is handled by the SceneStack)
+- name validation: ensures entered name meets requirements 
+- game flow: when Enter is pressed the game scene for the name replaces this one
+*/
+
+#include "WelcomeScene.h"
+#include <iostream>
+#include <cctype>
+#include <chrono>
+
+void WelcomeScene::setText(sf::Text& text, float x, float y) {
+    sf::FloatRect textRect = text.getLocalBounds();
+    text.setOrigin(textRect.left + textRect.width/2.0f,
+                    textRect.top + textRect.height/2.0f);
+    text.setPosition(sf::Vector2f(x, y));
+}
+
+WelcomeScene::WelcomeScene(SceneStack& stack, function<unique_ptr<Scene>(const string&)> startGame)
+    : Scene(stack), playerName(""), startGame(move(startGame)) {
+    const sf::Font& font = stack.getFont(); // loaded once by the stack, shared with the game
+    float width = stack.getWindow().getSize().x;
+    float height = stack.getWindow().getSize().y;
+
+    // set up welcome text 
+    welcomeText.setFont(font);
+    welcomeText.setString("WELCOME TO MINESWEEPER!");
+    welcomeText.setCharacterSize(24);
+    welcomeText.setFillColor(sf::Color::White);
+    welcomeText.setStyle(sf::Text::Bold | sf::Text::Underlined);
+    setText(welcomeText, width / 2.0f, height / 2.0f - 150);
+
+    // set up 'enter name' text
+    enterNameText.setFont(font);
+    enterNameText.setString("Enter your name: ");
+    enterNameText.setCharacterSize(20);
+    enterNameText.setFillColor(sf::Color::White);
+    enterNameText.setStyle(sf::Text::Bold);
+    setText(enterNameText, width / 2.0f, height / 2.0f - 75);
+
+    // set up input text
+    inputText.setFont(font);
+    inputText.setCharacterSize(18);
+    inputText.setFillColor(sf::Color::Yellow);
+    inputText.setStyle(sf::Text::Bold);
+    updateInputText();
+}
+
+void WelcomeScene::updateInputText() {
+    // add cursor to text field 
+    inputText.setString(playerName + "|");
+    setText(inputText, stack.getWindow().getSize().x / 2.0f, stack.getWindow().getSize().y / 2.0f - 45);
+}
+
+void WelcomeScene::submitName() {
+    if (!playerName.empty()) {
+        // cout << "Returning name: " << playerName << endl; // debugging
+        auto requestTime = chrono::steady_clock::now(); // before the game scene is built, that's part of the switch
+        stack.replace(startGame(playerName), requestTime);
+    }
+}
+
+void WelcomeScene::handleEvent(const sf::Event& event) {
+    // added this bc the code block below using unicode '13' for return/enter did not work
+    if (event.type == sf::Event::KeyPressed) {
+        if (event.key.code == sf::Keyboard::Return || event.key.code == sf::Keyboard::Enter) {
+            // cout << "Enter key pressed via KeyPressed event" << endl;
+            submitName();
+            return;
+        }
+    }
+
+    if (event.type == sf::Event::TextEntered) { 
+        if (event.text.unicode == 8) { // backspace
+            if (!playerName.empty()) {
+                playerName.pop_back();
+            }
+        }
+        else if (event.text.unicode == 13) { // enter
+            submitName();
+        }
+        else if (event.text.unicode < 128 && isalpha(event.text.unicode) && playerName.length() < 10) { // only add alphabetical letters 
+            char inputChar = static_cast<char>(event.text.unicode);
+            if (playerName.empty()) {
+                playerName += toupper(inputChar);
+            } else {
+                playerName += tolower(inputChar);
+            }
+        }
+        updateInputText();
+    }
+}
+
+void WelcomeScene::draw(sf::RenderWindow& window) {
+    window.clear(sf::Color(0, 0, 255)); // clear blue background 
+
+    // draw window elements
+    FrameProfiler& profiler = stack.getProfiler();
+    profiler.draw(window, welcomeText);
+    profiler.draw(window, enterNameText);
+    profiler.draw(window, inputText);
+}
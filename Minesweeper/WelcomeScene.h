@@ -0,0 +1,50 @@
+/*
+purpose: implements initial welcome screen of game
+handles player name input before starting the actual game
+
+implementation:
+- first scene on the SceneStack when game launched
+- displayes welcome message and prompts for player name input 
+- handles keyboard input with validation:
+    - limit to 10 characters
+    - only alphabetical characters
+    - formats name (first letter capitalized, rest lowercase)
+- processes enter key to proceed with game
+- displays cursor 
+hands the player name to main's startGame, whose scene (the game) replaces this one
+*/
+
+#ifndef WELCOMESCENE_H
+#define WELCOMESCENE_H
+
+#include "Scene.h"
+#include "SceneStack.h"
+#include <SFML/Graphics.hpp>
+#include <string>
+#include <memory>
+#include <functional>
+using namespace std;
+
+class WelcomeScene : public Scene {
+private:
+    sf::Text welcomeText;
+    sf::Text enterNameText;
+    sf::Text inputText;
+    string playerName;
+    function<unique_ptr<Scene>(const string&)> startGame;
+
+    void setText(sf::Text& text, float x, float y);
+    void submitName();
+    void updateInputText(); // name + cursor, only when the name changes
+
+public:
+    WelcomeScene(SceneStack& stack, function<unique_ptr<Scene>(const string&)> startGame);
+
+    void handleEvent(const sf::Event& event) override;
+    void draw(sf::RenderWindow& window) override;
+    bool isIdle() const override { return true; } // the text only changes on events
+};
+
+
+
+#endif
@@ -0,0 +1,567 @@
+/*
+purpose: leaderboard service process, owns the leaderboard store for every game on this machine
+
+usage: leaderboard_daemon [leaderboard file] [socket path] [entries kept per config]
+       leaderboard_daemon --self-test
+(defaults: leaderboard.txt and leaderboard.sock in the current directory, run it next to the game,
+and LeaderboardStore::DEFAULT_CAPACITY entries; the leaderboard view pages through any size)
+
+- loads the whole leaderboard into memory once, queries are answered from memory
+- games connect over a Unix domain socket (local only, see LeaderboardProtocol.h)
+- submitted wins are re-simulated here, ranked in memory straight away (so the reply already
+  has the new table) and written to disk in batches: one locked append per BATCH_SIZE
+  wins or FLUSH_MILLIS, whichever comes first
+- every verified win also goes into the player's stats (player_stats.dat next to the
+  leaderboard file), flushed with the same batches; games only ever send the replay, so
+  the stats' times and 3BV/s are the verified ones
+- single threaded poll() loop, every client socket is non-blocking; the store is only
+  touched on this thread
+- replays are verified on a pool of worker threads (VerifyPool), so one big or slow
+  submission never stalls the other clients; a worker hands its result back through a
+  pipe the poll loop watches, and the loop stages it and writes the reply
+- a client's frames are answered in order: while its submission is being verified its
+  later frames wait in its buffer; a client that hangs up before its verification finishes
+  (its DAEMON_TIMEOUT_MILLIS ran out, it stored the win itself) doesn't get it staged here
+- frames are cut out of a client's buffer by moving an offset, the consumed bytes are
+  dropped once per read (same for the send buffer once per write)
+- ctrl+c / SIGTERM flushes whatever is still staged before exiting
+- --self-test feeds forged submissions (and a few real ones) through the same checks a client's
+  'S' frame goes through (nothing is written, no socket) and exits non zero if a forged one
+  gets in or a real one doesn't
+builds without SFML: g++ -std=c++17 -O2 -pthread leaderboard_daemon.cpp LeaderboardService.cpp LeaderboardProtocol.cpp
+                     LeaderboardStore.cpp PlayerStatsStore.cpp TDigest.cpp FileLock.cpp MappedFile.cpp ReplayVerifier.cpp ReplayPlayer.cpp Replay.cpp Board.cpp GameArena.cpp SessionTrace.cpp
+*/
+
+#include "LeaderboardStore.h"
+#include "LeaderboardService.h"
+#include "LeaderboardProtocol.h"
+#include "Board.h"
+#include <iostream>
+#include <fstream>
+#include <filesystem>
+#include <chrono>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <csignal>
+#include <cstring>
+#include <poll.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+using namespace std;
+
+static const size_t BATCH_SIZE = 256;
+static const int FLUSH_MILLIS = 50;
+
+static volatile sig_atomic_t stopRequested = 0;
+
+static void onSignal(int) {
+    stopRequested = 1;
+}
+
+static void setNonBlocking(int fd) {
+    fcntl(fd, F_SETFL, fcntl(fd, F_GETFL, 0) | O_NONBLOCK);
+}
+
+struct Client {
+    uint64_t id;              // verification results find their client by this (fds get reused)
+    int fd;
+    vector<uint8_t> received; // bytes read, frames before receivedOffset are done
+    size_t receivedOffset;
+    vector<uint8_t> toSend;   // replies, bytes before sentOffset are written
+    size_t sentOffset;
+    bool verifying;           // waiting on a submission, later frames wait too
+};
+
+// one submitted win, parsed on the poll thread, verified on a worker
+struct VerifyJob {
+    uint64_t clientId;
+    uint32_t count;
+    string playerName;
+    vector<uint8_t> replayBytes;
+    LeaderboardSubmission submission; // filled in by the worker (accepted / reason / config / record)
+};
+
+// worker threads that run LeaderboardService::verifySubmission, the poll loop collects
+// finished jobs when the wake pipe is readable
+class VerifyPool {
+private:
+    vector<thread> workers;
+    mutex queueMutex;
+    condition_variable queueReady;
+    deque<VerifyJob> pending;
+    deque<VerifyJob> done;
+    bool stopping;
+    int wakeFds[2]; // [0] polled by the loop, [1] written by the workers
+
+    void workerLoop() {
+        while (true) {
+            VerifyJob job;
+            {
+                unique_lock<mutex> lock(queueMutex);
+                queueReady.wait(lock, [this] { return stopping || !pending.empty(); });
+                if (stopping) {
+                    return; // jobs still queued at shutdown are dropped, nobody waits for the reply
+                }
+                job = move(pending.front());
+                pending.pop_front();
+            }
+
+            job.submission.accepted = LeaderboardService::verifySubmission(job.playerName, job.replayBytes, job.submission.config,
+                                                                           job.submission.record, job.submission.reason);
+            job.replayBytes = vector<uint8_t>(); // not needed anymore, don't hold it in the done queue
+            {
+                lock_guard<mutex> lock(queueMutex);
+                done.push_back(move(job));
+            }
+            char wake = 1;
+            if (::write(wakeFds[1], &wake, 1) < 0) {
+                // pipe full: the loop is already due to wake up and drain everything
+            }
+        }
+    }
+
+public:
+    explicit VerifyPool(int threadCount) : stopping(false) {
+        if (::pipe(wakeFds) != 0) {
+            wakeFds[0] = wakeFds[1] = -1;
+        }
+        setNonBlocking(wakeFds[0]);
+        setNonBlocking(wakeFds[1]);
+        for (int i = 0; i < threadCount; ++i) {
+            workers.emplace_back(&VerifyPool::workerLoop, this);
+        }
+    }
+
+    ~VerifyPool() {
+        {
+            lock_guard<mutex> lock(queueMutex);
+            stopping = true;
+        }
+        queueReady.notify_all();
+        for (auto& worker : workers) {
+            worker.join();
+        }
+        ::close(wakeFds[0]);
+        ::close(wakeFds[1]);
+    }
+
+    int getWakeFd() const { return wakeFds[0]; }
+
+    void submit(VerifyJob job) {
+        {
+            lock_guard<mutex> lock(queueMutex);
+            pending.push_back(move(job));
+        }
+        queueReady.notify_one();
+    }
+
+    // everything finished since the last call
+    void takeDone(deque<VerifyJob>& finished) {
+        char drain[256];
+        while (::read(wakeFds[0], drain, sizeof(drain)) > 0) {}
+        lock_guard<mutex> lock(queueMutex);
+        finished.swap(done);
+    }
+};
+
+static int listenOn(const string& socketPath) {
+    sockaddr_un address;
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    if (socketPath.size() >= sizeof(address.sun_path)) {
+        return -1;
+    }
+    memcpy(address.sun_path, socketPath.c_str(), socketPath.size());
+
+    int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) {
+        return -1;
+    }
+    ::unlink(socketPath.c_str()); // left over from a previous run
+    if (::bind(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 || ::listen(fd, 128) != 0) {
+        ::close(fd);
+        return -1;
+    }
+    setNonBlocking(fd);
+    return fd;
+}
+
+// the other end closed its socket
+static bool hungUp(int fd) {
+    pollfd check = {fd, 0, 0};
+    return poll(&check, 1, 0) > 0 && (check.revents & (POLLHUP | POLLERR));
+}
+
+// answer one request frame, false = malformed (client gets dropped)
+// a submit isn't answered here: it's parsed into `job` (queued = true) for the verify pool
+static bool handleRequest(LeaderboardStore& store, const uint8_t* payload, uint32_t payloadSize, FrameWriter& reply,
+                          VerifyJob& job, bool& queued) {
+    queued = false;
+    FrameReader request(payload, payloadSize);
+    char type;
+    if (!request.get(type)) {
+        return false;
+    }
+
+    if (type == 'T') {
+        int32_t colCount, rowCount, mineCount;
+        uint32_t count;
+        if (!request.get(colCount) || !request.get(rowCount) || !request.get(mineCount) || !request.get(count)) {
+            return false;
+        }
+        reply.putRecords(store.top({colCount, rowCount, mineCount}, min<size_t>(count, MAX_PAGE_ROWS)));
+        return true;
+    }
+
+    if (type == 'P') {
+        int32_t colCount, rowCount, mineCount;
+        uint64_t offset;
+        uint32_t count;
+        if (!request.get(colCount) || !request.get(rowCount) || !request.get(mineCount) || !request.get(offset) || !request.get(count)) {
+            return false;
+        }
+        reply.putPage(store.page({colCount, rowCount, mineCount}, offset, min(count, MAX_PAGE_ROWS)));
+        return true;
+    }
+
+    if (type == 'S') {
+        if (!request.get(job.count) || !request.getString(job.playerName)) {
+            return false;
+        }
+        job.replayBytes.assign(request.remaining(), request.remaining() + request.remainingSize());
+        queued = true;
+        return true;
+    }
+
+    return false;
+}
+
+// a verified (or rejected) submission: stage it + count it in the player's stats and build
+// the reply, on the poll thread
+static void finishSubmission(LeaderboardStore& store, PlayerStatsStore& stats, VerifyJob& job, FrameWriter& reply, size_t& staged) {
+    LeaderboardSubmission& submission = job.submission;
+    LeaderboardRecord& record = submission.record;
+    if (submission.accepted) {
+        submission.madeTopK = store.stage(submission.config, record);
+        submission.rank = store.rankOf(submission.config, record.timeMillis, record.order);
+        submission.top = store.top(submission.config, min<size_t>(job.count, MAX_PAGE_ROWS));
+        stats.record(job.playerName, submission.config, record.timeMillis, record.bbbvPerSecond, true);
+        staged++;
+    }
+    reply.putSubmission(submission);
+}
+
+static void queueReply(Client& client, const FrameWriter& reply) {
+    uint32_t size = reply.bytes.size();
+    const uint8_t* sizeBytes = reinterpret_cast<const uint8_t*>(&size);
+    client.toSend.insert(client.toSend.end(), sizeBytes, sizeBytes + sizeof(size));
+    client.toSend.insert(client.toSend.end(), reply.bytes.begin(), reply.bytes.end());
+}
+
+// answer every whole frame the client has buffered, stopping at a submission (its reply
+// has to come first), false = malformed
+static bool processFrames(Client& client, LeaderboardStore& store, VerifyPool& pool) {
+    const uint8_t* payload;
+    uint32_t payloadSize;
+    int got = 0;
+    while (!client.verifying && (got = takeFrame(client.received, client.receivedOffset, payload, payloadSize)) == 1) {
+        FrameWriter reply;
+        VerifyJob job = {};
+        bool queued;
+        if (!handleRequest(store, payload, payloadSize, reply, job, queued)) {
+            return false;
+        }
+        if (queued) {
+            job.clientId = client.id;
+            pool.submit(move(job));
+            client.verifying = true;
+        } else {
+            queueReply(client, reply);
+        }
+    }
+    // drop the consumed frames once, not per frame
+    client.received.erase(client.received.begin(), client.received.begin() + client.receivedOffset);
+    client.receivedOffset = 0;
+    return got >= 0;
+}
+
+// a replay as a client would send it (same layout ReplayRecorder writes, see Replay.h)
+static vector<uint8_t> encodeReplay(const Replay& replay) {
+    vector<uint8_t> bytes = {'M', 'S', 'R', 'P', 1};
+    writeVarint(bytes, replay.header.seed);
+    writeVarint(bytes, replay.header.colCount);
+    writeVarint(bytes, replay.header.rowCount);
+    writeVarint(bytes, replay.header.mineCount);
+    writeVarint(bytes, replay.header.playerName.size());
+    bytes.insert(bytes.end(), replay.header.playerName.begin(), replay.header.playerName.end());
+    uint32_t tick = 0, cell = 0;
+    for (const ReplayMove& move : replay.moves) {
+        int64_t cellDelta = static_cast<int64_t>(move.cell) - static_cast<int64_t>(cell);
+        uint64_t zigzag = (static_cast<uint64_t>(cellDelta) << 1) ^ static_cast<uint64_t>(cellDelta >> 63);
+        writeVarint(bytes, move.tick - tick);
+        writeVarint(bytes, (zigzag << 2) | static_cast<uint8_t>(move.action));
+        tick = move.tick;
+        cell = move.cell;
+    }
+    writeVarint(bytes, replay.endTick - tick);
+    writeVarint(bytes, static_cast<uint8_t>(ReplayAction::End));
+    bytes.push_back(static_cast<uint8_t>(replay.result));
+    return bytes;
+}
+
+// a real win on a small board: a reveal on every safe tile that's still hidden, `step` ms apart
+static Replay winningReplay(const string& playerName, uint32_t step) {
+    Replay replay = {};
+    replay.header = {42, 9, 9, 10, playerName};
+    Board board;
+    board.generate(9, 9, 10, 42);
+    uint32_t tick = 0;
+    for (int cell = 0; cell < board.getCellCount(); ++cell) {
+        if (!board.isMine(cell) && !board.isRevealed(cell)) {
+            board.reveal(cell);
+            tick += step;
+            replay.moves.push_back({tick, static_cast<uint32_t>(cell), ReplayAction::Reveal});
+        }
+    }
+    replay.endTick = tick + step;
+    replay.result = ReplayResult::Won;
+    return replay;
+}
+
+// reason = why it has to be rejected, empty = it has to be accepted
+static bool expectResult(const string& what, const string& playerName, const Replay& replay, const string& reason) {
+    BoardConfig config;
+    LeaderboardRecord record;
+    string got;
+    bool accepted = LeaderboardService::verifySubmission(playerName, encodeReplay(replay), config, record, got);
+    bool passed = reason.empty() ? accepted : !accepted && got == reason;
+    cout << (passed ? "ok   " : "FAIL ") << what << " (" << (accepted ? "accepted" : got) << ")" << endl;
+    return passed;
+}
+
+static int selfTest() {
+    bool passed = true;
+
+    // a name that would add its own leaderboard line (a 1 ms win nobody verified), in both the request and the replay
+    string forged = "a,0\n30,16,99,1,Forged";
+    Replay replay = {};
+    replay.header = {12345, 30, 16, 99, forged};
+    replay.moves = {{1000, 0, ReplayAction::Reveal}};
+    replay.endTick = 60000;
+    replay.result = ReplayResult::Won;
+    passed &= expectResult("name with a line break", forged, replay, "bad player name");
+
+    replay.header.playerName = "";
+    passed &= expectResult("empty name", "", replay, "bad player name");
+
+    replay.header.playerName = forged;
+    passed &= expectResult("good request name, forged replay name", "Alice", replay, "unreadable replay");
+
+    // a few bytes claiming a won game on a board far bigger than the game allows
+    replay.header = {12345, 8192, 8192, 10, "Alice"};
+    passed &= expectResult("board bigger than the game allows", "Alice", replay, "bad board size");
+
+    // left+right: the chord can come right after its first button's click on the same tile,
+    // but only once, and only after a reveal / flag
+    Replay win = winningReplay("Alice", 100);
+    passed &= expectResult("plain win", "Alice", win, "");
+    Replay pair = win;
+    pair.moves.insert(pair.moves.begin() + 1, {pair.moves[0].tick, pair.moves[0].cell, ReplayAction::Chord});
+    passed &= expectResult("reveal + chord on the same tile 0 ms apart", "Alice", pair, "");
+    Replay chords = pair;
+    chords.moves.insert(chords.moves.begin() + 2, {pair.moves[0].tick, pair.moves[0].cell, ReplayAction::Chord});
+    passed &= expectResult("chord + chord on the same tile 0 ms apart", "Alice", chords, "moves too close together");
+    Replay late = win;
+    late.moves.insert(late.moves.begin() + 1, {win.moves[0].tick, win.moves[1].cell, ReplayAction::Chord});
+    passed &= expectResult("chord on another tile 0 ms after a reveal", "Alice", late, "moves too close together");
+
+    // the store refuses it too, even if something else let it through
+    LeaderboardStore store("self_test_leaderboard.txt"); // only staged, never flushed
+    LeaderboardRecord record = {1, forged, 0, 0.0, 0.0, 0};
+    bool stored = store.stage({30, 16, 99}, record);
+    cout << (stored ? "FAIL " : "ok   ") << "store refuses a name with a comma" << endl;
+    passed &= !stored;
+
+    cout << (passed ? "self test passed" : "self test FAILED") << endl;
+    return passed ? 0 : 1;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc == 2 && string(argv[1]) == "--self-test") {
+        return selfTest();
+    }
+    string leaderboardPath = argc > 1 ? argv[1] : "leaderboard.txt";
+    string socketPath = argc > 2 ? argv[2] : LEADERBOARD_SOCKET;
+    size_t capacity = LeaderboardStore::DEFAULT_CAPACITY;
+    if (argc > 3) {
+        string text = argv[3];
+        size_t used = 0;
+        try {
+            capacity = stoul(text, &used);
+        } catch (const exception&) {
+            used = 0;
+        }
+        // stoul would also take "-1" (as a huge K) or "10x"
+        if (used == 0 || used != text.size() || text[0] == '-' || capacity == 0) {
+            cerr << "usage: leaderboard_daemon [leaderboard file] [socket path] [entries kept per config]" << endl;
+            cerr << "entries kept per config must be a positive number, got \"" << text << "\"" << endl;
+            return 1;
+        }
+    }
+    int verifyThreads = max(1u, thread::hardware_concurrency());
+
+    // old mm:ss lines belong to the board the game is configured for
+    BoardConfig legacyConfig = {0, 0, 0};
+    ifstream config("config.cfg");
+    config >> legacyConfig.colCount >> legacyConfig.rowCount >> legacyConfig.mineCount;
+
+    LeaderboardStore store(leaderboardPath, capacity);
+    PlayerStatsStore stats(filesystem::path(leaderboardPath).replace_filename("player_stats.dat").string());
+    auto loadStart = chrono::steady_clock::now();
+    store.load(legacyConfig);
+    store.compact(); // also builds the index for games that run without the daemon
+    cout << "loaded " << leaderboardPath << " in "
+         << chrono::duration<double, milli>(chrono::steady_clock::now() - loadStart).count() << " ms" << endl;
+
+    int listenFd = listenOn(socketPath);
+    if (listenFd < 0) {
+        cerr << "Failed to listen on " << socketPath << ": " << strerror(errno) << endl;
+        return 1;
+    }
+    signal(SIGINT, onSignal);
+    signal(SIGTERM, onSignal);
+    signal(SIGPIPE, SIG_IGN);
+    cout << "listening on " << socketPath << endl;
+
+    VerifyPool pool(verifyThreads);
+    vector<Client> clients;
+    uint64_t nextClientId = 1;
+    vector<pollfd> pollFds;
+    size_t staged = 0;
+    auto firstStaged = chrono::steady_clock::now();
+    deque<VerifyJob> finished;
+
+    while (!stopRequested) {
+        pollFds.clear();
+        pollFds.push_back({listenFd, POLLIN, 0});
+        pollFds.push_back({pool.getWakeFd(), POLLIN, 0});
+        for (const Client& client : clients) {
+            // a client waiting on a verification isn't read from, so it can't pile up frames meanwhile
+            short events = (client.verifying ? 0 : POLLIN) | (client.sentOffset < client.toSend.size() ? POLLOUT : 0);
+            pollFds.push_back({client.fd, events, 0});
+        }
+
+        int timeout = staged > 0 ? FLUSH_MILLIS : -1;
+        if (poll(pollFds.data(), pollFds.size(), timeout) < 0 && errno != EINTR) {
+            break;
+        }
+
+        // new games connecting
+        if (pollFds[0].revents & POLLIN) {
+            int fd;
+            while ((fd = ::accept(listenFd, nullptr, nullptr)) >= 0) {
+                setNonBlocking(fd);
+                noSigPipe(fd);
+                clients.push_back({nextClientId++, fd, {}, 0, {}, 0, false});
+            }
+        }
+
+        // verified submissions: stage them, reply, then carry on with that client's later frames.
+        // a client that hung up meanwhile timed out and put the win in the file itself (see
+        // LeaderboardService::askDaemon), staging it too would rank it twice
+        size_t stagedBefore = staged;
+        if (pollFds[1].revents & POLLIN) {
+            pool.takeDone(finished);
+            for (VerifyJob& job : finished) {
+                auto client = find_if(clients.begin(), clients.end(), [&](const Client& c) { return c.id == job.clientId; });
+                if (client == clients.end() || client->fd < 0 || hungUp(client->fd)) {
+                    if (job.submission.accepted) {
+                        cerr << "client left before its win was verified, not staged" << endl;
+                    }
+                    continue;
+                }
+                FrameWriter reply;
+                finishSubmission(store, stats, job, reply, staged);
+                queueReply(*client, reply);
+                client->verifying = false;
+                if (!processFrames(*client, store, pool)) {
+                    ::close(client->fd);
+                    client->fd = -1;
+                }
+            }
+            finished.clear();
+        }
+        if (stagedBefore == 0 && staged > 0) {
+            firstStaged = chrono::steady_clock::now();
+        }
+
+        // pollFds[i + 2] belongs to clients[i] (new clients were added after the poll)
+        size_t polledClients = pollFds.size() - 2;
+        for (size_t i = 0; i < polledClients; ++i) {
+            Client& client = clients[i];
+            short events = pollFds[i + 2].revents;
+            bool drop = client.fd < 0 || (events & (POLLERR | POLLNVAL));
+
+            if (!drop && (events & (POLLIN | POLLHUP))) {
+                uint8_t buffer[64 * 1024];
+                ssize_t n;
+                while ((n = ::read(client.fd, buffer, sizeof(buffer))) > 0) {
+                    client.received.insert(client.received.end(), buffer, buffer + n);
+                }
+                if (n == 0 || (n < 0 && errno != EAGAIN && errno != EWOULDBLOCK)) {
+                    drop = true;
+                }
+
+                if (!processFrames(client, store, pool)) {
+                    drop = true;
+                }
+            }
+
+            // write as much of the pending replies as the socket takes
+            while (!drop && client.sentOffset < client.toSend.size()) {
+                ssize_t n = sendNoSignal(client.fd, client.toSend.data() + client.sentOffset, client.toSend.size() - client.sentOffset);
+                if (n < 0) {
+                    drop = errno != EAGAIN && errno != EWOULDBLOCK;
+                    break;
+                }
+                client.sentOffset += n;
+            }
+            if (client.sentOffset > 0) {
+                client.toSend.erase(client.toSend.begin(), client.toSend.begin() + client.sentOffset);
+                client.sentOffset = 0;
+            }
+
+            if (drop && client.fd >= 0) {
+                ::close(client.fd);
+            }
+            if (drop) {
+                client.fd = -1;
+            }
+        }
+        clients.erase(remove_if(clients.begin(), clients.end(), [](const Client& c) { return c.fd < 0; }), clients.end());
+
+        // batched disk write
+        if (staged >= BATCH_SIZE || (staged > 0 && chrono::steady_clock::now() - firstStaged >= chrono::milliseconds(FLUSH_MILLIS))) {
+            store.flush();
+            stats.flush(); // keeps its games for the next batch if it can't write
+            staged = 0;
+        }
+    }
+
+    store.flush();
+    stats.flush();
+    for (const Client& client : clients) {
+        ::close(client.fd);
+    }
+    ::close(listenFd);
+    ::unlink(socketPath.c_str());
+    cout << "stopped" << endl;
+    return 0;
+}
@@ -1,17 +1,37 @@
 /*
 purpose: main entry point for game
-init and coordinates diff game windows and components 
+init and coordinates diff game scenes and components 
 
 implementation overview: 
 - configuration loading: 
     - reads board dimensions and mine count from config.cfg file 
+    - optional 4th value: crash journal durability lag in ms (default 50)
+    - optional 5th value: startup budget in ms for the first frame (0 = none, default),
+      the startup profile (when it's on) says whether it was kept
     - sets up default values if config is not found
     - validates configuration values to ensure the meet the minimum req
 
 - game flow management: 
-    - creates the welcome window to get player's name
-    - init the main game window with proper dimensions 
-    - passed player info between windows 
+    - one window for the whole run (SceneStack), created once with proper dimensions
+    - starts on the welcome scene to get player's name
+    - the welcome scene swaps itself for the game scene, main hands it the config to build it with
+    - the game scene resumes the player's unfinished game (closed or crashed) by itself
+
+- replays: 
+    - "project3 --replay <file.msr>" skips the welcome scene and plays the replay back
+      in a window sized for that replay's board
+
+- tracing: "--trace <file.json>" (with or without --replay) records the whole session as a
+  Chrome trace (see SessionTrace.h), stopped after every scene and its threads are gone
+
+- startup: assets come from the compiled-in pack when the game is built with one
+  (see pack_assets.cpp), otherwise the images start decoding on worker threads right
+  away so they're resident before the player has typed a name
+- startup profile: with "--profile-startup" (or MINESWEEPER_PROFILE_STARTUP set to anything
+  but 0) every phase up to the game's first frame is reported on stdout; the phases are the
+  session trace's "startup" category (see SessionTrace.h), so with --trace they're in that
+  file, without it they're traced to startup_trace.json until the report; a normal run
+  prints and writes nothing
 
 - error handling: 
     - handles missing files and invalid configurations 
@@ -23,18 +43,95 @@ implementation overview:
 #include <fstream>
 #include <string>
 #include <cctype>
-#include "WelcomeWindow.h"
-#include "GameWindow.h"
-#include "LeaderboardWindow.h"
+#include <memory>
+#include <chrono>
+#include <vector>
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include "SceneStack.h"
+#include "ResourceCache.h"
+#include "SessionTrace.h"
+#include "WelcomeScene.h"
+#include "GameScene.h"
+
+
+// opens the game just for watching one replay file
+int watchReplay(const string& path) {
+    Replay replay;
+    SessionTrace::Scope loadTrace("load replay", SessionTrace::STARTUP);
+    if (!loadReplay(path, replay)) {
+        cerr << "Unable to read replay: " << path << endl;
+        return 1;
+    }
+    loadTrace.end();
+
+    int colCount = replay.header.colCount;
+    int rowCount = replay.header.rowCount;
+    if (colCount <= 0 || rowCount <= 0 || colCount > Board::MAX_SIDE || rowCount > Board::MAX_SIDE
+        || replay.header.mineCount < 1 || replay.header.mineCount >= colCount * rowCount) {
+        cerr << "Replay has an invalid board: " << path << endl;
+        return 1;
+    }
+    SceneStack stack(colCount * 32, (rowCount * 32) + 100, "Minesweeper");
+    stack.push(make_unique<GameScene>(stack, replay)); // never touches that player's own save / journal
+    stack.run();
+    return 0;
+}
+
+int main(int argc, char* argv[]) {
+    auto startTime = chrono::steady_clock::now(); // trace timestamps count from here
+
+    vector<string> args(argv + 1, argv + argc);
+    for (size_t i = 0; i + 1 < args.size(); ++i) {
+        if (args[i] == "--trace") {
+            if (SessionTrace::start(args[i + 1], startTime)) {
+                SessionTrace::nameThread("ui");
+            }
+            args.erase(args.begin() + i, args.begin() + i + 2);
+            break;
+        }
+    }
+    const char* profileEnv = getenv("MINESWEEPER_PROFILE_STARTUP");
+    bool profileStartup = profileEnv && *profileEnv && strcmp(profileEnv, "0") != 0;
+    auto profileArg = find(args.begin(), args.end(), "--profile-startup");
+    if (profileArg != args.end()) {
+        profileStartup = true;
+        args.erase(profileArg);
+    }
+    if (profileStartup) {
+        // no --trace: trace just the startup, the report stops it
+        bool traceJustStartup = !SessionTrace::isEnabled();
+        if (traceJustStartup && SessionTrace::start("startup_trace.json", startTime)) {
+            SessionTrace::nameThread("ui");
+        }
+        SessionTrace::reportStartup(traceJustStartup);
+    }
 
+    // textures decode on worker threads while the window opens and the player types
+    ResourceCache::get().startPreload();
 
-int main() {
+    if (args.size() >= 2 && args[0] == "--replay") {
+        int result = watchReplay(args[1]);
+        SessionTrace::stop();
+        return result;
+    }
+
+    SessionTrace::Scope configTrace("config", SessionTrace::STARTUP);
     ifstream config("config.cfg");
     int colCount, rowCount, mineCount;
+    int journalLagMillis = 50;
+    int startupBudgetMillis = 0;
 
     // load config.cfg file is available 
     if (config.is_open()) {
         config >> colCount >> rowCount >> mineCount;
+        if (!(config >> journalLagMillis)) {
+            journalLagMillis = 50; // older config files only have 3 values
+        }
+        if (!(config >> startupBudgetMillis)) {
+            startupBudgetMillis = 0;
+        }
         config.close();
         // cout << "Read from config: columns=" << colCount << ", rows=" << rowCount 
                  // << ", mines=" << mineCount << endl; // debugging 
@@ -48,30 +145,31 @@ int main() {
     // handling edge cases & ensuring proper size for all text/buttons on screen
     if (colCount < 22) colCount = 22;
     if (rowCount < 16) rowCount = 16;
+    if (colCount > Board::MAX_SIDE) colCount = Board::MAX_SIDE; // the verifier wouldn't take bigger games
+    if (rowCount > Board::MAX_SIDE) rowCount = Board::MAX_SIDE;
 
     int totalTiles = colCount * rowCount;
     if (mineCount < 1) mineCount = 1;
     if (mineCount >= totalTiles) mineCount = totalTiles - 1;
+    SessionTrace::setStartupBudget(startupBudgetMillis);
+    configTrace.end();
 
     int width = colCount*32;
     int height = (rowCount * 32) + 100;
     // cout << "Window dimensions: " << width << "x" << height << endl; // debugging 
 
-    // create welcome window
-    WelcomeWindow welcomeWindow(width, height);
-
-    // get player name 
-    string playerName = welcomeWindow.run();
-
-    if (playerName.empty()) {
-        cout << "Empty player name." << endl;
-        return 0;
-    }
-
+    {
+        // one window for everything, the welcome scene first
+        SceneStack stack(width, height, "Minesweeper");
 
-    // start game functionality after getting player name 
-    GameWindow gameWindow(width, height, colCount, rowCount, mineCount, playerName);
-    gameWindow.run();
+        // start game functionality after getting player name 
+        auto startGame = [&](const string& playerName) -> unique_ptr<Scene> {
+            return make_unique<GameScene>(stack, colCount, rowCount, mineCount, playerName, journalLagMillis);
+        };
+        stack.push(make_unique<WelcomeScene>(stack, startGame));
+        stack.run();
+    } // scenes gone: the leaderboard worker + journal writer have finished
 
+    SessionTrace::stop();
     return 0;
 }
\ No newline at end of file
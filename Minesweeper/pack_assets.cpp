@@ -0,0 +1,87 @@
+/*
+purpose: build step that bakes every game asset into AssetPack.inc, which ResourceCache.cpp
+compiles into the game so it starts without reading or decoding any asset file
+
+usage: pack_assets [output file]   (default AssetPack.inc, run it in the Minesweeper folder)
+
+- every texture (in TextureId order, paths from ResourceCache) is decoded here once and
+  stored as raw RGBA, back to back in one blob; the font's bytes follow (FreeType reads
+  them straight from memory)
+- the output is a C++ include: a table of (width, height, offset) per texture, (offset,
+  size) per font, the blob as one static array, and the file every entry came from
+  (ResourceCache.cpp refuses to compile a pack whose files aren't its own, in the same order)
+- rerun it whenever something in images/ or font.ttf changes; without AssetPack.inc the
+  game just loads the files like before
+builds with SFML: g++ -std=c++17 -O2 -DMINESWEEPER_PACKING pack_assets.cpp ResourceCache.cpp SessionTrace.cpp -lsfml-graphics -lsfml-window -lsfml-system
+(MINESWEEPER_PACKING leaves the current AssetPack.inc out, so a stale one can't break this build)
+*/
+
+#include "ResourceCache.h"
+#include <SFML/Graphics.hpp>
+#include <iostream>
+#include <fstream>
+#include <iterator>
+#include <vector>
+#include <string>
+#include <cstdio>
+using namespace std;
+
+int main(int argc, char* argv[]) {
+    string outputPath = argc > 1 ? argv[1] : "AssetPack.inc";
+
+    vector<uint8_t> blob;
+    string textureTable;
+    string fontTable;
+    string textureFiles;
+    string fontFiles;
+
+    for (size_t i = 0; i < TEXTURE_COUNT; ++i) {
+        const char* path = ResourceCache::path(static_cast<TextureId>(i));
+        sf::Image image;
+        if (!image.loadFromFile(path)) {
+            cerr << "Failed to load " << path << endl;
+            return 1;
+        }
+        // keep every image 4 byte aligned in the blob
+        while (blob.size() % 4 != 0) blob.push_back(0);
+
+        sf::Vector2u size = image.getSize();
+        const uint8_t* pixels = image.getPixelsPtr();
+        textureTable += "    {" + to_string(size.x) + ", " + to_string(size.y) + ", " + to_string(blob.size()) + "}, // " + path + "\n";
+        textureFiles += "    \"" + string(path) + "\",\n";
+        blob.insert(blob.end(), pixels, pixels + size.x * size.y * 4);
+    }
+
+    for (size_t i = 0; i < FONT_COUNT; ++i) {
+        const char* path = ResourceCache::path(static_cast<FontId>(i));
+        ifstream file(path, ios::binary);
+        if (!file) {
+            cerr << "Failed to load " << path << endl;
+            return 1;
+        }
+        vector<uint8_t> bytes((istreambuf_iterator<char>(file)), istreambuf_iterator<char>());
+        fontTable += "    {" + to_string(blob.size()) + ", " + to_string(bytes.size()) + "}, // " + path + "\n";
+        fontFiles += "    \"" + string(path) + "\",\n";
+        blob.insert(blob.end(), bytes.begin(), bytes.end());
+    }
+
+    FILE* output = fopen(outputPath.c_str(), "w");
+    if (!output) {
+        cerr << "Failed to write " << outputPath << endl;
+        return 1;
+    }
+    fprintf(output, "// generated by pack_assets from images/ and font.ttf, do not edit\n\n");
+    fprintf(output, "static const PackedTexture PACKED_TEXTURES[%zu] = {\n%s};\n\n", TEXTURE_COUNT, textureTable.c_str());
+    fprintf(output, "static const PackedFont PACKED_FONTS[%zu] = {\n%s};\n\n", FONT_COUNT, fontTable.c_str());
+    fprintf(output, "static constexpr const char* PACKED_TEXTURE_FILES[%zu] = {\n%s};\n\n", TEXTURE_COUNT, textureFiles.c_str());
+    fprintf(output, "static constexpr const char* PACKED_FONT_FILES[%zu] = {\n%s};\n\n", FONT_COUNT, fontFiles.c_str());
+    fprintf(output, "alignas(4) static const uint8_t ASSET_PACK[%zu] = {\n", blob.size());
+    for (size_t i = 0; i < blob.size(); ++i) {
+        fprintf(output, "%u,%s", blob[i], i % 32 == 31 ? "\n" : "");
+    }
+    fprintf(output, "\n};\n");
+    bool written = fclose(output) == 0;
+
+    cout << "packed " << TEXTURE_COUNT << " textures + " << FONT_COUNT << " font(s), " << blob.size() << " bytes -> " << outputPath << endl;
+    return written ? 0 : 1;
+}
@@ -0,0 +1,69 @@
+/*
+purpose: command line tool that checks a batch of replay files (e.g. a whole tournament's submissions)
+
+usage: verify_replays [-j threads] [--trace file.json] <replay files or directories...>
+
+prints every rejected replay with the reason, then a summary with how many replays per second were checked,
+--trace writes every verification (per thread) as a Chrome trace, see SessionTrace.h
+builds without SFML: g++ -std=c++17 -O2 -pthread verify_replays.cpp ReplayVerifier.cpp ReplayPlayer.cpp Replay.cpp Board.cpp GameArena.cpp MappedFile.cpp SessionTrace.cpp
+*/
+
+#include "ReplayVerifier.h"
+#include "SessionTrace.h"
+#include <iostream>
+#include <filesystem>
+#include <chrono>
+#include <thread>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <cstdlib>
+using namespace std;
+
+int main(int argc, char* argv[]) {
+    int threadCount = max(1u, thread::hardware_concurrency());
+    vector<string> paths;
+
+    for (int i = 1; i < argc; ++i) {
+        string arg = argv[i];
+        if (arg == "-j" && i + 1 < argc) {
+            threadCount = max(1, atoi(argv[++i]));
+        } else if (arg == "--trace" && i + 1 < argc) {
+            SessionTrace::start(argv[++i]);
+        } else if (filesystem::is_directory(arg)) {
+            for (const auto& entry : filesystem::directory_iterator(arg)) {
+                if (entry.path().extension() == ".msr") {
+                    paths.push_back(entry.path().string());
+                }
+            }
+        } else {
+            paths.push_back(arg);
+        }
+    }
+
+    if (paths.empty()) {
+        cerr << "usage: verify_replays [-j threads] [--trace file.json] <replay files or directories...>" << endl;
+        SessionTrace::stop();
+        return 1;
+    }
+
+    auto start = chrono::steady_clock::now();
+    vector<VerifyResult> results = ReplayVerifier::verifyFiles(paths, threadCount);
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    SessionTrace::stop();
+
+    size_t validCount = 0;
+    for (size_t i = 0; i < results.size(); ++i) {
+        if (results[i].valid) {
+            validCount++;
+        } else {
+            cout << "REJECTED " << paths[i] << ": " << results[i].reason << endl;
+        }
+    }
+
+    cout << validCount << "/" << results.size() << " replays valid, checked in " << seconds * 1000 << " ms ("
+         << static_cast<long long>(results.size() / max(seconds, 1e-9)) << " replays/s on "
+         << threadCount << " threads)" << endl;
+
+    return validCount == results.size() ? 0 : 2;
+}